@@ -0,0 +1,114 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <numeric>
+#include <ostream>
+#include <vector>
+
+namespace Chip8::Bench {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double time_body(Benchmark const& benchmark, std::uint64_t const iterations) {
+    auto const start{Clock::now()};
+    benchmark.body(iterations);
+    return std::chrono::duration<double>{Clock::now() - start}.count();
+}
+
+std::uint64_t calibrate(Benchmark const& benchmark, Options const& options) {
+    std::uint64_t iterations{1};
+
+    // Grow until the run is long enough to time, then scale to the target time
+    while (true) {
+        double const seconds{time_body(benchmark, iterations)};
+        if (seconds >= options.min_seconds / 10 || iterations >= (std::uint64_t{1} << 40)) {
+            return std::max<std::uint64_t>(
+                1, static_cast<std::uint64_t>(static_cast<double>(iterations) *
+                                              (options.min_seconds / std::max(seconds, 1e-9))));
+        }
+        iterations *= 10;
+    }
+}
+
+std::string escape(std::string const& text) {
+    std::string escaped{};
+    for (char const character : text) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+} // namespace
+
+Result run(Benchmark const& benchmark, Options const& options) {
+    Result result{.name = benchmark.name};
+    result.iterations =
+        benchmark.iterations != 0 ? benchmark.iterations : calibrate(benchmark, options);
+
+    // Warm up caches, branch predictors and CPU frequency
+    static_cast<void>(time_body(benchmark, result.iterations));
+
+    for (std::size_t repetition{0}; repetition < std::max<std::size_t>(options.repetitions, 1);
+         ++repetition) {
+        double const seconds{time_body(benchmark, result.iterations)};
+        result.samples.push_back(seconds * 1e9 / static_cast<double>(result.iterations));
+    }
+
+    std::vector<double> sorted{result.samples};
+    std::ranges::sort(sorted);
+    std::size_t const middle{sorted.size() / 2};
+    result.median =
+        sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+    result.min = sorted.front();
+    result.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) /
+                  static_cast<double>(sorted.size());
+
+    double variance{0};
+    for (double const sample : sorted) {
+        variance += (sample - result.mean) * (sample - result.mean);
+    }
+    result.stddev = std::sqrt(variance / static_cast<double>(sorted.size()));
+
+    return result;
+}
+
+void write_table(std::ostream& out, std::vector<Result> const& results) {
+    std::size_t width{9};
+    for (Result const& result : results) {
+        width = std::max(width, result.name.size());
+    }
+
+    out << std::format("{:<{}}  {:>12}  {:>10}  {:>10}  {:>7}  {:>14}\n", "benchmark", width,
+                       "iterations", "ns/op", "min ns/op", "cv", "ops/s");
+    for (Result const& result : results) {
+        double const cv{result.mean > 0 ? result.stddev / result.mean : 0};
+        out << std::format("{:<{}}  {:>12}  {:>10.3f}  {:>10.3f}  {:>6.2f}%  {:>14.0f}\n",
+                           result.name, width, result.iterations, result.median, result.min,
+                           cv * 100, result.operations_per_second());
+    }
+}
+
+void write_json(std::ostream& out, std::vector<Result> const& results, Options const& options) {
+    out << "{\n  \"repetitions\": " << options.repetitions << ",\n  \"benchmarks\": [";
+
+    for (std::size_t idx{0}; idx < results.size(); ++idx) {
+        Result const& result{results[idx]};
+        out << std::format("{}\n    {{\"name\": \"{}\", \"iterations\": {}, "
+                           "\"ns_per_op_median\": {:.4f}, \"ns_per_op_mean\": {:.4f}, "
+                           "\"ns_per_op_stddev\": {:.4f}, \"ns_per_op_min\": {:.4f}, "
+                           "\"ops_per_second\": {:.0f}}}",
+                           idx == 0 ? "" : ",", escape(result.name), result.iterations,
+                           result.median, result.mean, result.stddev, result.min,
+                           result.operations_per_second());
+    }
+
+    out << "\n  ]\n}\n";
+}
+} // namespace Chip8::Bench
@@ -0,0 +1,65 @@
+#ifndef CHIP8_BENCH_HARNESS_H
+#define CHIP8_BENCH_HARNESS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Chip8::Bench {
+/** @brief Keep a value alive, so the compiler cannot optimise away the work producing it. */
+template <typename T> inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(*static_cast<T const volatile*>(&value));
+#endif
+}
+
+/**
+ * @brief A benchmark, which performs the given number of operations each time its body is called.
+ * When iterations is zero, the harness picks a count which runs for long enough to time reliably.
+ */
+struct Benchmark {
+    std::string name;
+    std::function<void(std::uint64_t iterations)> body;
+    std::uint64_t iterations{0};
+};
+
+/** @brief Timings of a benchmark, over every repetition, in nanoseconds per operation. */
+struct Result {
+    std::string name;
+    std::uint64_t iterations{0};
+    std::vector<double> samples;
+
+    double median{0};
+    double mean{0};
+    double stddev{0};
+    double min{0};
+
+    [[nodiscard]] double operations_per_second() const { return median > 0 ? 1e9 / median : 0; }
+};
+
+struct Options {
+    std::size_t repetitions{10};
+    // Calibrated benchmarks run for at least this long per repetition
+    double min_seconds{0.05};
+    // Only benchmarks whose names contain this are run
+    std::string filter;
+};
+
+/**
+ * @brief Run a benchmark: once to warm up, then for each repetition, recording the time per
+ * operation. The median is reported as the headline figure, as it is robust against interruptions.
+ */
+[[nodiscard]] Result run(Benchmark const& benchmark, Options const& options);
+
+/** @brief Write results as an aligned table. */
+void write_table(std::ostream& out, std::vector<Result> const& results);
+
+/** @brief Write results as JSON, for tracking over time. */
+void write_json(std::ostream& out, std::vector<Result> const& results, Options const& options);
+} // namespace Chip8::Bench
+#endif // CHIP8_BENCH_HARNESS_H
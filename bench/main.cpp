@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chip8/config.h"
+#include "chip8/emulator.h"
+#include "chip8/instruction.h"
+#include "chip8/instruction_set.h"
+#include "chip8/jit.h"
+#include "chip8/parse.h"
+#include "chip8/random.h"
+#include "chip8/system.h"
+#include "harness.h"
+
+namespace {
+using Chip8::Bench::Benchmark;
+using Chip8::Bench::do_not_optimize;
+
+constexpr std::string_view USAGE{
+    "Usage: chip8-bench [options]\n"
+    "  --filter <text>      only run benchmarks whose names contain text\n"
+    "  --repetitions <n>    timed repetitions of each benchmark (default 10)\n"
+    "  --min-time <ms>      minimum time per repetition of micro benchmarks (default 50)\n"
+    "  --cycles <n>         instructions per repetition of ROM benchmarks (default 10000000)\n"
+    "  --rom-dir <path>     also benchmark every .ch8 ROM in a directory\n"
+    "  --json <path>        write results as JSON"};
+
+/**
+ * @brief Benchmark one instruction function, called repeatedly on a system prepared by setup. The
+ * function pointer is hidden from the optimiser, so each call is a real dispatch, as in execution.
+ */
+Benchmark handler_benchmark(std::string name, std::uint16_t const opcode,
+                            std::function<void(Chip8::System&)> const& setup = {}) {
+    auto const system{std::make_shared<Chip8::System>()};
+    system->seed(0);
+    system->index_register = 0x300;
+    std::fill_n(system->memory.begin() + 0x300, 0x40, std::uint8_t{0xA5});
+    if (setup) {
+        setup(*system);
+    }
+
+    Chip8::Instruction const instruction{opcode};
+    Chip8::InstructionSet::InstructionFunctionPtr const execute{
+        Chip8::InstructionSet::decode<Chip8::SuperChipQuirks>(instruction)};
+
+    return {.name = "handler/" + std::move(name),
+            .body =
+                [system, instruction, execute](std::uint64_t const iterations) {
+                    auto function{execute};
+                    do_not_optimize(function);
+                    for (std::uint64_t i{0}; i < iterations; ++i) {
+                        (system.get()->*function)(instruction);
+                    }
+                    do_not_optimize(*system);
+                },
+            .iterations = 0};
+}
+
+void set_registers(Chip8::System& system, std::uint8_t const x, std::uint8_t const y) {
+    system.registers.at(0x1) = x;
+    system.registers.at(0x2) = y;
+}
+
+void hires(Chip8::System& system) {
+    system.display.resize(Chip8::System::HIRES_WIDTH, Chip8::System::HIRES_HEIGHT);
+}
+
+std::vector<Benchmark> handler_benchmarks() {
+    return {
+        handler_benchmark("add_vx_nn", 0x7105),
+        handler_benchmark("add_vx_vy", 0x8124, [](auto& system) { set_registers(system, 3, 7); }),
+        handler_benchmark("sub_vx_vy", 0x8125, [](auto& system) { set_registers(system, 3, 7); }),
+        handler_benchmark("shr_vx_vy", 0x8126, [](auto& system) { set_registers(system, 3, 7); }),
+        handler_benchmark("xor_vx_vy", 0x8123, [](auto& system) { set_registers(system, 3, 7); }),
+        handler_benchmark("rnd_vx_nn", 0xC1FF),
+        handler_benchmark("drw_8x5", 0xD125, [](auto& system) { set_registers(system, 30, 9); }),
+        handler_benchmark("drw_16x16", 0xD120,
+                          [](auto& system) {
+                              hires(system);
+                              set_registers(system, 60, 20);
+                          }),
+        handler_benchmark("sc_down", 0x00C4, hires),
+        handler_benchmark("sc_right", 0x00FB, hires),
+        handler_benchmark("sc_left", 0x00FC, hires),
+        handler_benchmark("mov_i_vx", 0xFF55),
+        handler_benchmark("mov_vx_i", 0xFF65),
+    };
+}
+
+/** @brief Throughput of decoding and executing a mix of straight line instructions. */
+Benchmark decode_benchmark() {
+    static constexpr std::size_t MIX_SIZE{256};
+    static constexpr std::array<std::uint16_t, 11> TEMPLATES{
+        0x6000, 0x7000, 0x8000, 0x8001, 0x8002, 0x8003, 0x8004, 0x8005, 0x8007, 0xA000, 0xF01E};
+
+    auto const mix{std::make_shared<std::array<std::uint16_t, MIX_SIZE>>()};
+    Chip8::Pcg32 random{};
+    for (std::uint16_t& instruction : *mix) {
+        std::uint16_t const opcode{TEMPLATES.at(random() % TEMPLATES.size())};
+        // Fill in the operands, keeping the opcode's fixed bits
+        std::uint16_t const operands{
+            static_cast<std::uint16_t>(opcode >= 0xF000 ? (random() & 0x0F00)
+                                       : (opcode & 0xF000) == 0x8000 ? (random() & 0x0FF0)
+                                                                     : (random() & 0x0FFF))};
+        instruction = static_cast<std::uint16_t>(opcode | operands);
+    }
+
+    auto const emulator{std::make_shared<Chip8::Emulator>()};
+
+    return {.name = "decode/decodeInstruction",
+            .body =
+                [emulator, mix](std::uint64_t const iterations) {
+                    for (std::uint64_t i{0}; i < iterations; ++i) {
+                        emulator->decodeInstruction(Chip8::Instruction{(*mix)[i % MIX_SIZE]});
+                    }
+                    do_not_optimize(emulator->system);
+                },
+            .iterations = 0};
+}
+
+/**
+ * @brief Arithmetic, drawing and subroutine calls in a loop, standing in for a typical game when no
+ * ROMs are available.
+ */
+constexpr std::array<std::uint8_t, 26> SYNTHETIC_ROM{
+    0x60, 0x00, // 0x200: V0 = 0
+    0x61, 0x00, // 0x202: V1 = 0
+    0x70, 0x01, // 0x204: V0 += 1
+    0x81, 0x04, // 0x206: V1 += V0
+    0x82, 0x13, // 0x208: V2 ^= V1
+    0xA0, 0x00, // 0x20A: I = font sprite for 0
+    0xD1, 0x25, // 0x20C: draw at V1, V2
+    0x22, 0x14, // 0x20E: call 0x214
+    0x12, 0x04, // 0x210: jump to 0x204
+    0x00, 0x00, // 0x212: unused
+    0x83, 0x06, // 0x214: V3 >>= 1
+    0x84, 0x24, // 0x216: V4 += V2
+    0x00, 0xEE, // 0x218: return
+};
+
+/** @brief Run a ROM from reset for the given cycles, in frames with timer updates between. */
+Benchmark rom_benchmark(std::string const& name,
+                        std::shared_ptr<std::vector<std::uint8_t> const> rom,
+                        Chip8::Backend const backend, std::uint64_t const cycles) {
+    return {.name = "rom/" + name +
+                    (backend == Chip8::Backend::INTERPRETER ? "/interpreter" : "/jit"),
+            .body =
+                [rom, backend](std::uint64_t const iterations) {
+                    Chip8::Emulator emulator{};
+                    emulator.setBackend(backend);
+                    emulator.system.seed(0);
+                    emulator.loadRom(*rom);
+
+                    std::uint64_t const frame_cycles{emulator.getConfig().tick_rate};
+                    for (std::uint64_t done{0}; done < iterations; done += frame_cycles) {
+                        emulator.run(std::min(frame_cycles, iterations - done));
+                        emulator.updateTimers();
+                    }
+                    do_not_optimize(emulator.system);
+                },
+            .iterations = cycles};
+}
+
+void add_rom_benchmarks(std::vector<Benchmark>& benchmarks, std::string const& name,
+                        std::shared_ptr<std::vector<std::uint8_t> const> const& rom,
+                        std::uint64_t const cycles) {
+    benchmarks.push_back(rom_benchmark(name, rom, Chip8::Backend::INTERPRETER, cycles));
+    if (Chip8::Jit::supported()) {
+        benchmarks.push_back(rom_benchmark(name, rom, Chip8::Backend::JIT, cycles));
+    }
+}
+
+void add_rom_directory(std::vector<Benchmark>& benchmarks, std::filesystem::path const& directory,
+                       std::uint64_t const cycles) {
+    if (!std::filesystem::is_directory(directory)) {
+        return;
+    }
+
+    std::vector<std::filesystem::path> paths{};
+    for (auto const& entry : std::filesystem::directory_iterator{directory}) {
+        if (entry.is_regular_file() && entry.path().extension() == ".ch8") {
+            paths.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+
+    for (std::filesystem::path const& path : paths) {
+        std::ifstream file{path, std::ios::binary};
+        auto const rom{std::make_shared<std::vector<std::uint8_t> const>(
+            std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{})};
+        add_rom_benchmarks(benchmarks, path.stem().string(), rom, cycles);
+    }
+}
+} // namespace
+
+int main(int const argc, char const* const argv[]) {
+    Chip8::Bench::Options options{};
+    std::uint64_t cycles{10'000'000};
+    std::vector<std::filesystem::path> rom_directories{CHIP8_BENCH_ROM_DIR};
+    std::string json_path{};
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view const arg{argv[i]};
+        if (i + 1 >= argc) {
+            std::println(stderr, "Error: missing value for {}\n{}", arg, USAGE);
+            return EXIT_FAILURE;
+        }
+        std::string_view const value{argv[++i]};
+        std::optional<std::uint64_t> const number{Chip8::parse_number<std::uint64_t>(value)};
+
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--repetitions" && number) {
+            options.repetitions = *number;
+        } else if (arg == "--min-time" && number) {
+            options.min_seconds = static_cast<double>(*number) / 1000;
+        } else if (arg == "--cycles" && number) {
+            cycles = *number;
+        } else if (arg == "--rom-dir") {
+            rom_directories.emplace_back(value);
+        } else if (arg == "--json") {
+            json_path = value;
+        } else {
+            std::println(stderr, "Error: invalid option: {} {}\n{}", arg, value, USAGE);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks{handler_benchmarks()};
+    benchmarks.push_back(decode_benchmark());
+    add_rom_benchmarks(benchmarks, "synthetic",
+                       std::make_shared<std::vector<std::uint8_t> const>(SYNTHETIC_ROM.begin(),
+                                                                         SYNTHETIC_ROM.end()),
+                       cycles);
+    for (std::filesystem::path const& directory : rom_directories) {
+        add_rom_directory(benchmarks, directory, cycles);
+    }
+
+    std::vector<Chip8::Bench::Result> results{};
+    for (Benchmark const& benchmark : benchmarks) {
+        if (benchmark.name.contains(options.filter)) {
+            results.push_back(Chip8::Bench::run(benchmark, options));
+            std::println(stderr, "Finished {}", benchmark.name);
+        }
+    }
+
+    Chip8::Bench::write_table(std::cout, results);
+
+    if (!json_path.empty()) {
+        std::ofstream file{json_path};
+        Chip8::Bench::write_json(file, results, options);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include "batch_runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "chip8/emulator.h"
+#include "chip8/input_log.h"
+#include "chip8/profiler.h"
+#include "chip8/system.h"
+#include "thread_pool.h"
+
+namespace Chip8::Batch {
+namespace {
+/** @brief Quote a CSV field, doubling any quotes within it. */
+std::string csv_quoted(std::string_view const field) {
+    std::string text{"\""};
+    for (char const c : field) {
+        text += c;
+        if (c == '"') {
+            text += '"';
+        }
+    }
+    text += '"';
+    return text;
+}
+} // namespace
+
+Result run_job(Job const& job) {
+    using namespace std::chrono;
+
+    Result result{.rom_path = job.rom_path, .rom_hash = job.rom_hash, .seed = job.seed};
+
+    try {
+        Emulator emulator{job.config};
+        emulator.setBackend(job.backend);
+        emulator.system.seed(job.seed);
+
+        bool exited{false};
+        emulator.loadRom(job.rom->bytes());
+
+        auto const start{steady_clock::now()};
+
+        std::optional<InputPlayer> player{};
+        if (job.input) {
+            player.emplace(*job.input);
+        }
+
+        std::shared_ptr<Profiler> profiler{};
+        if (job.profile_interval != 0) {
+            profiler = std::make_shared<Profiler>(job.profile_interval);
+        }
+
+        std::uint64_t const frame_cycles{std::max<std::uint64_t>(job.config.tick_rate, 1)};
+        while (result.cycles < job.cycles && !exited) {
+            std::uint64_t const cycles{std::min(frame_cycles, job.cycles - result.cycles)};
+
+            if (profiler) {
+                profiler->run(emulator, cycles, player ? &*player : nullptr);
+            } else if (player) {
+                player->run(emulator, cycles);
+            } else {
+                emulator.run(cycles);
+            }
+            emulator.updateTimers();
+            result.cycles += cycles;
+
+            while (auto const event{emulator.system.events.pop()}) {
+                exited |= *event == Event::EXIT;
+            }
+        }
+
+        result.seconds = duration<double>{steady_clock::now() - start}.count();
+        result.display_hash = emulator.system.display.hash();
+        result.profile = std::move(profiler);
+#ifdef CHIP8_INSTRUMENTATION
+        result.stats = std::make_shared<InstrumentationStats const>(emulator.getStats());
+#endif
+    } catch (std::exception const& exception) {
+        result.error = exception.what();
+    }
+
+    return result;
+}
+
+std::vector<Result> run_jobs(std::vector<Job> const& jobs, std::size_t const threads) {
+    std::vector<Result> results(jobs.size());
+
+    ThreadPool pool{threads};
+    for (std::size_t idx{0}; idx < jobs.size(); ++idx) {
+        pool.submit([&jobs, &results, idx] { results[idx] = run_job(jobs[idx]); });
+    }
+    pool.wait();
+
+    return results;
+}
+
+void write_results(std::ostream& out, std::vector<Result> const& results) {
+    out << "rom,rom_hash,seed,cycles,display_hash,wall_seconds,instructions_per_second,error\n";
+
+    for (Result const& result : results) {
+        out << std::format("{},{:016X},{},{},{:016X},{:.6f},{:.0f},{}\n",
+                           csv_quoted(result.rom_path), result.rom_hash, result.seed, result.cycles,
+                           result.display_hash, result.seconds, result.instructions_per_second(),
+                           csv_quoted(result.error));
+    }
+}
+} // namespace Chip8::Batch
@@ -0,0 +1,70 @@
+#ifndef CHIP8_BATCH_RUNNER_H
+#define CHIP8_BATCH_RUNNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "chip8/config.h"
+#include "chip8/emulator.h"
+#include "chip8/input_log.h"
+#include "chip8/profiler.h"
+#include "chip8/rom_library.h"
+
+namespace Chip8::Batch {
+/**
+ * @brief A single headless run of a ROM. The ROM is mapped once and held by shared pointer, so
+ * that jobs running the same ROM with different seeds share the mapping. When input is set, it is
+ * replayed at the instruction counts it was recorded at. When profile_interval is non-zero, the
+ * run is profiled.
+ */
+struct Job {
+    std::string rom_path;
+    std::shared_ptr<MappedRom const> rom;
+    std::uint64_t rom_hash{0};
+    std::uint32_t seed{0};
+    std::uint64_t cycles{0};
+    Config config{};
+    Backend backend{Backend::INTERPRETER};
+    std::shared_ptr<InputLog const> input;
+    std::uint32_t profile_interval{0};
+};
+
+/** @brief Outcome of a job. On failure, error is set and the other results are incomplete. */
+struct Result {
+    std::string rom_path{};
+    std::uint64_t rom_hash{0};
+    std::uint32_t seed{0};
+    std::uint64_t cycles{0};
+    std::uint64_t display_hash{0};
+    double seconds{0};
+    std::string error{};
+    std::shared_ptr<Profiler const> profile{};
+#ifdef CHIP8_INSTRUMENTATION
+    std::shared_ptr<InstrumentationStats const> stats{};
+#endif
+
+    [[nodiscard]] double instructions_per_second() const {
+        return seconds > 0 ? static_cast<double>(cycles) / seconds : 0;
+    }
+};
+
+/**
+ * @brief Run a job to completion on the calling thread. Cycles are executed in frames of the
+ * configured tick rate, with timers updated between frames, stopping early if the ROM exits.
+ */
+[[nodiscard]] Result run_job(Job const& job);
+
+/** @brief Run all jobs across a thread pool, returning results in the same order as the jobs. */
+[[nodiscard]] std::vector<Result> run_jobs(std::vector<Job> const& jobs, std::size_t threads);
+
+/**
+ * @brief Write results as CSV, with a header row. The ROM path and error are quoted, as either
+ * may contain commas.
+ */
+void write_results(std::ostream& out, std::vector<Result> const& results);
+} // namespace Chip8::Batch
+#endif // CHIP8_BATCH_RUNNER_H
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "batch_runner.h"
+#include "chip8/config.h"
+#include "chip8/emulator.h"
+#include "chip8/input_log.h"
+#include "chip8/parse.h"
+#include "chip8/profiler.h"
+#include "chip8/rom_database.h"
+#include "chip8/rom_library.h"
+
+namespace {
+constexpr std::string_view USAGE{
+    "Usage: chip8-batch [options] <rom or directory>...\n"
+    "  --frames <n>     60hz frames to run each ROM for (default 600)\n"
+    "  --cycles <n>     instructions to run each ROM for, instead of frames\n"
+    "  --seeds <n>      runs per ROM, each with a different seed (default 1)\n"
+    "  --seed <n>       first seed (default 0)\n"
+    "  --threads <n>    worker threads (default: all cores)\n"
+    "  --quirks <name>  chip8, schip or xochip, overriding each ROM's profile (default schip)\n"
+    "  --ipf <n>        instructions per frame, overriding each ROM's profile (default 15)\n"
+    "  --rom-db <path>  run each ROM with its quirks and instructions per frame from a database\n"
+    "  --jit            run with the JIT backend\n"
+    "  --replay <path>  replay an input log recorded by chip8-app, using its seed and quirks,\n"
+    "                   for its recorded length unless --cycles or --frames is given\n"
+    "  --profile <path> profile every run, writing folded stacks to path.folded and an\n"
+    "                   address heat map to path.heat\n"
+    "  --index <path>   keep an index of ROM hashes at path, so unchanged ROMs are not rehashed\n"
+    "  --output <path>  write CSV results to a file instead of stdout"};
+
+} // namespace
+
+int main(int const argc, char const* const argv[]) {
+    std::uint64_t frames{600};
+    std::optional<std::uint64_t> cycles{};
+    std::uint32_t seeds{1};
+    std::uint32_t first_seed{0};
+    std::size_t threads{std::thread::hardware_concurrency()};
+    std::optional<Chip8::Config> quirks{};
+    std::optional<std::uint16_t> ipf{};
+    std::string rom_db{};
+    Chip8::Backend backend{Chip8::Backend::INTERPRETER};
+    std::string output{};
+    std::shared_ptr<Chip8::InputLog const> input{};
+    bool length_given{false};
+    std::string profile_prefix{};
+    std::string index_path{};
+    std::vector<std::string> roms{};
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view const arg{argv[i]};
+        bool const has_value{i + 1 < argc};
+        std::string_view const value{has_value ? argv[i + 1] : ""};
+
+        std::optional<std::uint64_t> number{};
+        if (arg.starts_with("--") && arg != "--jit") {
+            if (!has_value) {
+                std::println(stderr, "Error: missing value for {}\n{}", arg, USAGE);
+                return EXIT_FAILURE;
+            }
+            ++i;
+            number = Chip8::parse_number<std::uint64_t>(value);
+        }
+
+        if (arg == "--frames" && number) {
+            frames = *number;
+            length_given = true;
+        } else if (arg == "--cycles" && number) {
+            cycles = *number;
+            length_given = true;
+        } else if (arg == "--seeds" && number) {
+            seeds = static_cast<std::uint32_t>(*number);
+        } else if (arg == "--seed" && number) {
+            first_seed = static_cast<std::uint32_t>(*number);
+        } else if (arg == "--threads" && number) {
+            threads = *number;
+        } else if (arg == "--quirks" && Chip8::Config::named(value)) {
+            quirks = Chip8::Config::named(value);
+        } else if (arg == "--ipf" && number > 0 &&
+                   number <= std::numeric_limits<std::uint16_t>::max()) {
+            ipf = static_cast<std::uint16_t>(*number);
+        } else if (arg == "--rom-db") {
+            rom_db = value;
+        } else if (arg == "--output") {
+            output = value;
+        } else if (arg == "--profile") {
+            profile_prefix = value;
+        } else if (arg == "--index") {
+            index_path = value;
+        } else if (arg == "--replay") {
+            try {
+                input = std::make_shared<Chip8::InputLog const>(Chip8::InputLog::read(value));
+            } catch (std::runtime_error const& error) {
+                std::println(stderr, "{}", error.what());
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--jit") {
+            backend = Chip8::Backend::JIT;
+        } else if (!arg.starts_with("--")) {
+            roms.emplace_back(arg);
+        } else {
+            std::println(stderr, "Error: invalid option: {} {}\n{}", arg, value, USAGE);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (roms.empty()) {
+        std::println(stderr, "{}", USAGE);
+        return EXIT_FAILURE;
+    }
+
+    // A replay must run exactly as recorded
+    if (input) {
+        quirks = input->config;
+        ipf = input->config.tick_rate;
+        first_seed = input->seed;
+        seeds = 1;
+        if (!length_given) {
+            cycles = input->instructions;
+        }
+    }
+
+    // Directories are expanded into the ROMs under them, which are listed by their full path
+    std::vector<std::pair<std::string, Chip8::RomInfo>> scanned{};
+    std::vector<Chip8::Batch::Job> jobs{};
+    Chip8::RomDatabase database{};
+    try {
+        if (!rom_db.empty()) {
+            database = Chip8::RomDatabase::read(rom_db);
+        }
+
+        Chip8::RomLibrary library{index_path};
+        for (std::string const& path : roms) {
+            if (std::filesystem::is_directory(path)) {
+                for (Chip8::RomInfo const& info : library.scan_directory(path)) {
+                    scanned.emplace_back(info.path, info);
+                }
+            } else {
+                scanned.emplace_back(path, library.scan(path));
+            }
+        }
+        library.save();
+    } catch (std::exception const& error) {
+        std::println(stderr, "{}", error.what());
+        return EXIT_FAILURE;
+    }
+
+    for (auto const& [path, info] : scanned) {
+        std::shared_ptr<Chip8::MappedRom const> rom{};
+        try {
+            rom = std::make_shared<Chip8::MappedRom const>(info.path);
+        } catch (std::runtime_error const& error) {
+            std::println(stderr, "{}", error.what());
+            return EXIT_FAILURE;
+        }
+
+        // Each ROM runs with its own profile, unless overridden
+        Chip8::Config config{};
+        if (Chip8::RomProfile const* const profile{database.find(info.hash)}) {
+            config = profile->config;
+        }
+        if (quirks) {
+            std::uint16_t const tick_rate{config.tick_rate};
+            config = *quirks;
+            config.tick_rate = tick_rate;
+        }
+        if (ipf) {
+            config.tick_rate = *ipf;
+        }
+
+        for (std::uint32_t seed{first_seed}; seed < first_seed + seeds; ++seed) {
+            jobs.push_back({.rom_path = path,
+                            .rom = rom,
+                            .rom_hash = info.hash,
+                            .seed = seed,
+                            .cycles = cycles.value_or(frames * config.tick_rate),
+                            .config = config,
+                            .backend = backend,
+                            .input = input,
+                            .profile_interval =
+                                profile_prefix.empty() ? 0 : Chip8::Profiler::DEFAULT_INTERVAL});
+        }
+    }
+
+    std::vector<Chip8::Batch::Result> const results{Chip8::Batch::run_jobs(jobs, threads)};
+
+    if (output.empty()) {
+        Chip8::Batch::write_results(std::cout, results);
+    } else {
+        std::ofstream file{output};
+        Chip8::Batch::write_results(file, results);
+    }
+
+    if (!profile_prefix.empty()) {
+        Chip8::Profiler profile{};
+        for (Chip8::Batch::Result const& result : results) {
+            if (result.profile) {
+                profile.merge(*result.profile);
+            }
+        }
+        try {
+            profile.write_files(profile_prefix);
+        } catch (std::runtime_error const& error) {
+            std::println(stderr, "{}", error.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+#ifdef CHIP8_INSTRUMENTATION
+    Chip8::InstrumentationStats totals{};
+    for (Chip8::Batch::Result const& result : results) {
+        if (result.stats) {
+            totals.merge(*result.stats);
+        }
+    }
+    totals.report(std::cerr);
+#endif
+
+    return std::ranges::any_of(results, [](auto const& result) { return !result.error.empty(); })
+               ? EXIT_FAILURE
+               : EXIT_SUCCESS;
+}
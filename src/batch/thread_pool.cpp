@@ -0,0 +1,104 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace Chip8::Batch {
+ThreadPool::ThreadPool(std::size_t const thread_count) {
+    std::size_t const count{std::max<std::size_t>(thread_count, 1)};
+
+    for (std::size_t idx{0}; idx < count; ++idx) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (std::size_t idx{0}; idx < count; ++idx) {
+        threads.emplace_back([this, idx] { worker_loop(idx); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock const lock{state_mutex};
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    // Workers finish any remaining tasks before exiting. Join them here, before the
+    // synchronisation members they use are destroyed.
+    threads.clear();
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        // Count the task before it is visible, so queued never underflows when it is taken
+        std::scoped_lock const lock{state_mutex};
+        ++queued;
+        ++pending;
+    }
+
+    WorkerQueue& queue{*queues.at(next_queue++ % queues.size())};
+    {
+        std::scoped_lock const lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+
+    work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock{state_mutex};
+    work_finished.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::try_take(std::size_t const worker, Task& task) {
+    // Own queue first, newest task first
+    {
+        WorkerQueue& own{*queues.at(worker)};
+        std::scoped_lock const lock{own.mutex};
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --queued;
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of another worker
+    for (std::size_t offset{1}; offset < queues.size(); ++offset) {
+        WorkerQueue& victim{*queues.at((worker + offset) % queues.size())};
+        std::scoped_lock const lock{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::worker_loop(std::size_t const worker) {
+    while (true) {
+        Task task{};
+
+        if (try_take(worker, task)) {
+            task();
+
+            if (--pending == 0) {
+                std::scoped_lock const lock{state_mutex};
+                work_finished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock{state_mutex};
+        work_available.wait(lock, [this] { return stopping || queued > 0; });
+
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+} // namespace Chip8::Batch
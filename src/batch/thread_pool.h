@@ -0,0 +1,61 @@
+#ifndef CHIP8_THREAD_POOL_H
+#define CHIP8_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Chip8::Batch {
+/**
+ * @brief Work stealing thread pool. Each worker owns a queue which tasks are distributed across.
+ * A worker takes tasks from the back of its own queue, and once it is empty steals from the front
+ * of the others, so that workers with short tasks keep busy until all work is done.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::jthread> threads;
+
+    // Tasks pushed but not yet taken, and tasks submitted but not yet finished
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> next_queue{0};
+
+    std::mutex state_mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    bool stopping{false};
+
+    bool try_take(std::size_t worker, Task& task);
+    void worker_loop(std::size_t worker);
+
+public:
+    explicit ThreadPool(std::size_t thread_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    [[nodiscard]] std::size_t size() const noexcept { return threads.size(); }
+
+    void submit(Task task);
+
+    /** @brief Block until every submitted task has finished. */
+    void wait();
+};
+} // namespace Chip8::Batch
+#endif // CHIP8_THREAD_POOL_H
@@ -0,0 +1,148 @@
+#include "block_cache.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "instruction.h"
+#include "instruction_set.h"
+#include "system.h"
+
+namespace Chip8 {
+namespace {
+/**
+ * @brief Whether an instruction ends a block. This is the case for any instruction which may
+ * modify the program counter (jumps, calls, returns, skips, key waits and exits), and for any
+ * instruction which writes to memory, as it may overwrite the code following it.
+ */
+constexpr bool ends_block(Instruction const instruction) {
+    switch (instruction.opcode()) {
+    case 0x0:
+        return instruction.nn() == 0xEE || instruction.nn() == 0xFD;
+    case 0x1:
+    case 0x2:
+    case 0x3:
+    case 0x4:
+    case 0x5:
+    case 0x9:
+    case 0xB:
+    case 0xE:
+        return true;
+    case 0xF:
+        return instruction.nn() == 0x0A || instruction.nn() == 0x33 || instruction.nn() == 0x55;
+    default:
+        return false;
+    }
+}
+
+/** @brief Recognise an idle loop starting with a block, from the block and the code after it. */
+IdleLoop classify_idle(System const& system, std::uint16_t const address, Block const& block) {
+    Instruction const first{block.instructions.front().instruction};
+
+    if (first.opcode() == 0x1 && first.nnn() == address) {
+        return IdleLoop::SELF_JUMP;
+    }
+    if (first.opcode() == 0xF && first.nn() == 0x0A) {
+        return IdleLoop::KEY_WAIT;
+    }
+
+    if (block.instructions.size() != 2 || address + 5 >= System::MEMORY_SIZE) {
+        return IdleLoop::NONE;
+    }
+    Instruction const skip{block.instructions.back().instruction};
+    Instruction const jump{system.memory[address + 4], system.memory[address + 5]};
+
+    bool const reads_timer{first.opcode() == 0xF && first.nn() == 0x07};
+    bool const skips_on_timer{(skip.opcode() == 0x3 || skip.opcode() == 0x4) &&
+                              skip.x() == first.x()};
+    bool const jumps_back{jump.opcode() == 0x1 && jump.nnn() == address};
+
+    return reads_timer && skips_on_timer && jumps_back ? IdleLoop::TIMER_POLL : IdleLoop::NONE;
+}
+} // namespace
+
+Block const& BlockCache::fetch(System const& system, std::uint16_t const address,
+                              InstructionSet::HandlerTable const& handlers) {
+    if (slots.empty()) {
+        slots.assign(System::MEMORY_SIZE, NO_SLOT);
+    }
+
+    // Bounds checked, so fetching a block from outside of memory fails as a fetch would
+    std::uint16_t& slot{slots.at(address)};
+    if (slot == NO_SLOT) {
+        slot = static_cast<std::uint16_t>(blocks.size());
+        blocks.emplace_back();
+    }
+    Block& block{blocks[slot]};
+
+    if (block.valid()) {
+        return block;
+    }
+
+    std::uint16_t current{address};
+    do {
+        Instruction const instruction{system.memory.at(current), system.memory.at(current + 1)};
+
+        block.instructions.push_back(
+            {.execute = handlers[InstructionSet::decode_index(instruction)],
+             .instruction = instruction});
+        current += 2;
+
+        if (ends_block(instruction)) {
+            break;
+        }
+    } while (block.instructions.size() < MAX_BLOCK_LENGTH && current + 1 < System::MEMORY_SIZE);
+
+    block.idle = classify_idle(system, address, block);
+
+    // A timer poll depends on the jump after the block too, so is invalidated along with it
+    block.pages = System::page_mask(
+        address, block.idle == IdleLoop::TIMER_POLL ? (current + 2) - address : current - address);
+
+    for (std::uint8_t page{0}; page < System::PAGE_COUNT; ++page) {
+        if ((block.pages & (1U << page)) != 0) {
+            page_blocks.at(page).push_back(address);
+        }
+    }
+
+    return block;
+}
+
+void BlockCache::drop(std::uint16_t const address) {
+    Block& block{blocks[slots[address]]};
+
+    // Unlist the block from every page it spans, so the lists never grow with stale addresses
+    for (std::uint8_t page{0}; page < System::PAGE_COUNT; ++page) {
+        if ((block.pages & (1U << page)) != 0) {
+            std::erase(page_blocks.at(page), address);
+        }
+    }
+
+    block.instructions.clear();
+    block.pages = 0;
+    block.native = nullptr;
+    block.idle = IdleLoop::NONE;
+}
+
+void BlockCache::invalidate(std::uint16_t const pages) {
+    for (std::uint8_t page{0}; page < System::PAGE_COUNT; ++page) {
+        if ((pages & (1U << page)) == 0) {
+            continue;
+        }
+
+        // Copy, as dropping a block erases it from the list being iterated
+        std::vector<std::uint16_t> const addresses{page_blocks.at(page)};
+        for (std::uint16_t const address : addresses) {
+            drop(address);
+        }
+    }
+}
+
+void BlockCache::clear() { invalidate(System::ALL_PAGES); }
+
+void BlockCache::clear_native() {
+    for (Block& block : blocks) {
+        block.native = nullptr;
+    }
+}
+} // namespace Chip8
@@ -0,0 +1,109 @@
+#ifndef CHIP8_BLOCK_CACHE_H
+#define CHIP8_BLOCK_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "instruction.h"
+#include "instruction_set.h"
+#include "system.h"
+
+namespace Chip8 {
+/**
+ * @brief An instruction which has already been fetched and decoded, storing the function which
+ * executes it alongside the instruction its operands are extracted from.
+ */
+struct DecodedInstruction {
+    InstructionSet::InstructionFunctionPtr execute;
+    Instruction instruction;
+};
+
+/**
+ * @brief Natively compiled block, executing every instruction of the block on the given system.
+ */
+using NativeBlock = void (*)(System*);
+
+/**
+ * @brief A loop which cannot make progress until the host next updates the timers or keys, so
+ * within a single run its iterations all leave the system in the same state.
+ *
+ * SELF_JUMP is a 1NNN jumping to itself. KEY_WAIT is an FX0A, which re-executes itself until a
+ * key is released. TIMER_POLL is an FX07 reading the delay timer into VX, then a 3XNN or 4XNN skip
+ * on VX, then a 1NNN jumping back to the FX07, which loops until the timer reaches some value.
+ */
+enum class IdleLoop : std::uint8_t {
+    NONE,
+    SELF_JUMP,
+    KEY_WAIT,
+    TIMER_POLL,
+};
+
+/**
+ * @brief A basic block: a run of decoded instructions starting at some address, ending at the
+ * first instruction which may modify the program counter or write to memory.
+ */
+struct Block {
+    std::vector<DecodedInstruction> instructions;
+    std::uint16_t pages{0}; // mask of the memory pages the block was decoded from
+    NativeBlock native{nullptr};
+    IdleLoop idle{IdleLoop::NONE}; // idle loop starting with the block
+
+    [[nodiscard]] bool valid() const { return !instructions.empty(); }
+};
+
+/**
+ * @brief Cache of decoded basic blocks, keyed by the address they start at. Blocks are decoded
+ * lazily on first fetch, and must be invalidated when the memory they were decoded from changes.
+ */
+class BlockCache {
+private:
+    static constexpr std::uint16_t NO_SLOT{0xFFFF};
+
+    // Index into blocks of the block starting at each address, allocated on the first fetch, so
+    // that emulators which are created but barely run stay cheap
+    std::vector<std::uint16_t> slots;
+    // Blocks in the order their addresses were first fetched. A deque, so references to blocks
+    // stay valid as it grows. Dropped blocks keep their slot, and are decoded again in place
+    std::deque<Block> blocks;
+    // Start addresses of the blocks decoded from each page, so invalidation only visits those
+    std::array<std::vector<std::uint16_t>, System::PAGE_COUNT> page_blocks;
+
+    void drop(std::uint16_t address);
+
+public:
+    /**
+     * @brief Maximum number of instructions in a block, bounding the cost of decoding straight
+     * line code which never branches.
+     */
+    static constexpr std::size_t MAX_BLOCK_LENGTH{64};
+
+    /**
+     * @brief Get the block starting at an address, decoding it from the system memory with the
+     * given handler table if it is not already cached.
+     */
+    Block const& fetch(System const& system, std::uint16_t address,
+                       InstructionSet::HandlerTable const& handlers);
+
+    /** @brief Get the block starting at an address, which must already have been fetched. */
+    [[nodiscard]] Block const& at(std::uint16_t const address) const {
+        return blocks[slots[address]];
+    }
+
+    /** @brief Drop every cached block decoded from any of the pages in a page mask. */
+    void invalidate(std::uint16_t pages);
+
+    /** @brief Drop every cached block. */
+    void clear();
+
+    /** @brief Attach native code to the block starting at an address. */
+    void set_native(std::uint16_t const address, NativeBlock const native) {
+        blocks[slots[address]].native = native;
+    }
+
+    /** @brief Detach native code from every block, keeping the decoded instructions. */
+    void clear_native();
+};
+} // namespace Chip8
+#endif // CHIP8_BLOCK_CACHE_H
@@ -1,37 +1,45 @@
 #include "config.h"
 
-#include <cstdint>
-
 #include "system.h"
 
 namespace Chip8 {
-bool Config::shift_quirk{false};
-bool Config::jump_quirk{false};
-bool Config::memory_quirk{false};
-bool Config::vblank_quirk{false};
-
-std::uint8_t Config::max_width{System::HIRES_WIDTH};
-std::uint8_t Config::max_height{System::HIRES_HEIGHT};
-
-void Config::load_chip8() {
-    shift_quirk = false;
-    jump_quirk = false;
-    memory_quirk = false;
-    vblank_quirk = false;
-
-    max_width = System::LORES_WIDTH;
-    max_height = System::LORES_HEIGHT;
+Config Config::chip8() {
+    return {.shift_quirk = false,
+            .jump_quirk = false,
+            .memory_quirk = false,
+            .vblank_quirk = false,
+            .max_width = System::LORES_WIDTH,
+            .max_height = System::LORES_HEIGHT};
 }
 
-void Config::load_super_chip() {
-    shift_quirk = true;
-    jump_quirk = true;
-    memory_quirk = true;
-    vblank_quirk = true;
+Config Config::super_chip() {
+    return {.shift_quirk = true,
+            .jump_quirk = true,
+            .memory_quirk = true,
+            .vblank_quirk = true,
+            .max_width = System::HIRES_WIDTH,
+            .max_height = System::HIRES_HEIGHT};
+}
 
-    max_width = System::HIRES_WIDTH;
-    max_height = System::HIRES_HEIGHT;
+Config Config::xo_chip() {
+    return {.shift_quirk = false,
+            .jump_quirk = false,
+            .memory_quirk = false,
+            .vblank_quirk = false,
+            .max_width = System::HIRES_WIDTH,
+            .max_height = System::HIRES_HEIGHT};
 }
 
-void Config::load_xo_chip() {}
-} // namespace Chip8
\ No newline at end of file
+std::optional<Config> Config::named(std::string_view const name) {
+    if (name == "chip8") {
+        return chip8();
+    }
+    if (name == "schip") {
+        return super_chip();
+    }
+    if (name == "xochip") {
+        return xo_chip();
+    }
+    return std::nullopt;
+}
+} // namespace Chip8
@@ -2,20 +2,49 @@
 #define CHIP8_CONFIG_H
 
 #include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "system.h"
 
 namespace Chip8 {
+/**
+ * @brief Compile time quirk policy. Instruction functions affected by a quirk are specialised on
+ * it, so that each policy gets its own branch free instantiation of the instruction set.
+ */
+template <bool Shift, bool Jump, bool Memory> struct QuirkPolicy {
+    static constexpr bool SHIFT{Shift};
+    static constexpr bool JUMP{Jump};
+    static constexpr bool MEMORY{Memory};
+};
+
+using Chip8Quirks = QuirkPolicy<false, false, false>;
+using SuperChipQuirks = QuirkPolicy<true, true, true>;
+using XoChipQuirks = QuirkPolicy<false, false, false>;
+
+/**
+ * @brief Configuration of a single emulator. Each emulator holds its own copy, so emulators with
+ * different configurations can run side by side, including on different threads. Defaults to the
+ * SUPER-CHIP configuration.
+ */
 struct Config {
-    static bool shift_quirk;
-    static bool jump_quirk;
-    static bool memory_quirk; // load store FX55 FX65 quirk
-    static bool vblank_quirk;
+    bool shift_quirk{true};
+    bool jump_quirk{true};
+    bool memory_quirk{true}; // load store FX55 FX65 quirk
+    bool vblank_quirk{true};
+
+    std::uint8_t max_width{System::HIRES_WIDTH};
+    std::uint8_t max_height{System::HIRES_HEIGHT};
+
+    // Instructions executed per 60hz frame
+    std::uint16_t tick_rate{15};
 
-    static std::uint8_t max_width;
-    static std::uint8_t max_height;
+    static Config chip8();
+    static Config super_chip();
+    static Config xo_chip();
 
-    static void load_chip8();
-    static void load_super_chip();
-    static void load_xo_chip();
+    /** @brief Look up a configuration by its command line name: chip8, schip or xochip. */
+    static std::optional<Config> named(std::string_view name);
 };
 } // namespace Chip8
 #endif // CHIP8_CONFIG_H
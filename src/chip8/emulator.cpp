@@ -2,26 +2,24 @@
 
 #include <algorithm>
 #include <array>
+#include <filesystem>
 #include <format>
-#include <fstream>
 #include <iterator>
 #include <print>
-#include <sstream>
 #include <stdexcept>
 
 #include "config.h"
 #include "fonts.h"
 #include "instruction.h"
 #include "instruction_set.h"
+#include "rom_library.h"
+#include "save_state.h"
 #include "system.h"
 
 namespace Chip8 {
-Emulator::Emulator() {
-    Config::load_super_chip();
-
-    system.display.reserve(static_cast<size_t>(Config::max_width * Config::max_height));
-    // Size to base size
-    system.display.resize(System::LORES_WIDTH * System::LORES_HEIGHT);
+Emulator::Emulator(Config const& config)
+    : config{config}, handlers{&InstructionSet::handlers(config.shift_quirk, config.jump_quirk,
+                                                         config.memory_quirk)} {
     // read fonts in
     std::ranges::copy(FONT, std::begin(system.memory));
     std::ranges::copy(BIG_FONT, std::begin(system.memory) + FONT.size());
@@ -29,41 +27,58 @@ Emulator::Emulator() {
 
 /** @brief Primary instruction decoding and execution function. */
 void Emulator::decodeInstruction(Instruction const instruction) {
-    for (auto const& row : InstructionSet::DECODE_TABLE) {
-        if (row.matches(instruction)) {
-            (system.*row.execute)(instruction);
-            return;
+    std::uint8_t const index{InstructionSet::decode_index(instruction)};
+
+#ifdef CHIP8_INSTRUMENTATION
+    instrumentation.count(index, system.program_counter);
+    if (instrumentation.sample()) {
+        std::uint64_t const start{Instrumentation::timestamp()};
+        (system.*(*handlers)[index])(instruction);
+        instrumentation.time(index, Instrumentation::timestamp() - start);
+        if (system.fault != Fault::NONE) [[unlikely]] {
+            throwFault();
         }
+        return;
     }
+#endif
+
+    (system.*(*handlers)[index])(instruction);
 
-    std::println(stderr, "Error: Invalid (or unimplemented) CHIP-8 instruction: 0x{:04X}",
-                 instruction.raw_data());
+    if (system.fault != Fault::NONE) [[unlikely]] {
+        throwFault();
+    }
 }
 
 void Emulator::loadRom(std::string_view filename) {
-    constexpr std::uint16_t START_IDX{0x200};
+    std::println("Loading rom from path: {}", filename);
 
-    if (std::ifstream file{filename.data(), std::ios::binary}) {
-        std::println("Loading rom from path: {}", filename);
-        std::ostringstream buffer{};
-        buffer << file.rdbuf();
-        std::string rom{buffer.str()};
+    // Mapped rather than read, so the copy into memory is the only one
+    MappedRom const rom{std::filesystem::path{filename}};
+    loadRom(rom.bytes());
+}
 
-        std::ranges::copy(rom, std::begin(system.memory) + START_IDX);
-    } else {
-        throw std::runtime_error(std::string("Error: file read went wrong"));
+void Emulator::loadRom(std::span<std::uint8_t const> const rom) {
+    if (rom.size() > System::MAX_ROM_SIZE) {
+        throw std::runtime_error{std::format("Error: ROM is {} bytes, but at most {} fit in memory",
+                                             rom.size(), System::MAX_ROM_SIZE)};
     }
 
-    system.program_counter = START_IDX;
+    std::ranges::copy(rom, std::begin(system.memory) + System::PROGRAM_START);
+
+    system.program_counter = System::PROGRAM_START;
+
+    invalidateCache();
 }
 
 bool Emulator::updateTimers() noexcept {
     if (system.delay_timer > 0) {
         system.delay_timer--;
     }
-    if (system.sound_timer > 0) {
-        system.sound_timer--;
+    if (system.sound_timer > 0 && --system.sound_timer == 0) {
+        system.events.push(Event::SOUND_OFF);
     }
+    system.events.push(Event::FRAME_READY);
+
     return system.sound_timer > 0;
 }
 
@@ -72,11 +87,268 @@ Instruction Emulator::getCurrentInstruction() const {
                        system.memory.at(system.program_counter + 1)};
 }
 
+void Emulator::setKey(std::uint8_t const key, bool const pressed) {
+    // For waiting
+    if (system.waiting && !pressed) {
+        system.key_released = key;
+    }
+
+    system.keys.at(key) = pressed ? 0x1 : 0x0;
+}
+
+void Emulator::invalidateCache() {
+    block_cache.clear();
+    system.dirty_pages = 0;
+    active_block = NO_BLOCK;
+}
+
+void Emulator::saveState(SaveState& state) const { state.capture(system); }
+
+SaveState Emulator::saveState() const {
+    SaveState state{};
+    saveState(state);
+    return state;
+}
+
+void Emulator::saveState(std::string_view const filename) const { saveState().write(filename); }
+
+void Emulator::loadState(SaveState const& state) {
+    state.restore(system);
+
+    // Memory has been replaced wholesale, so nothing decoded from it can be trusted
+    invalidateCache();
+}
+
+void Emulator::loadState(std::span<std::byte const> const bytes) {
+    loadState(SaveState::from_bytes(bytes));
+}
+
+void Emulator::loadState(std::string_view const filename) {
+    loadState(SaveState::read(filename));
+}
+
+void Emulator::setBackend(Backend const backend) {
+    if (backend != Backend::INTERPRETER && !jit) {
+        if (!Jit::supported()) {
+            throw std::runtime_error{"Error: the JIT backend is not supported on this platform"};
+        }
+        jit = std::make_unique<Jit>(system);
+    }
+
+    this->backend = backend;
+}
+
+void Emulator::syncCache() {
+    if (system.dirty_pages != 0) {
+        block_cache.invalidate(system.dirty_pages);
+        system.dirty_pages = 0;
+        active_block = NO_BLOCK;
+    }
+}
+
+bool Emulator::enterBlock() {
+    syncCache();
+
+    // Continue through the active block while execution follows it, otherwise switch blocks
+    if (active_block != NO_BLOCK &&
+        block_position != block_cache.at(active_block).instructions.size() &&
+        system.program_counter == active_block + (2 * block_position)) {
+        return false;
+    }
+
+    active_block = system.program_counter;
+    block_position = 0;
+    block_cache.fetch(system, active_block, *handlers);
+    return true;
+}
+
+std::size_t Emulator::skipIdle(Block const& block, std::size_t const cycles) noexcept {
+    switch (block.idle) {
+    case IdleLoop::NONE:
+        return 0;
+    case IdleLoop::SELF_JUMP:
+        return cycles;
+    case IdleLoop::KEY_WAIT:
+        if (system.key_released != 0xFF) {
+            return 0;
+        }
+        system.waiting = true;
+        return cycles;
+    case IdleLoop::TIMER_POLL: {
+        constexpr std::size_t LOOP_LENGTH{3};
+
+        // Each iteration reads the same timer value, so if the first does not leave the loop,
+        // none do, and whole iterations end where they started
+        Instruction const read{block.instructions.front().instruction};
+        Instruction const skip{block.instructions.back().instruction};
+        bool const equal{system.delay_timer == skip.nn()};
+        bool const leaves{skip.opcode() == 0x3 ? equal : !equal};
+
+        std::size_t const skipped{cycles - (cycles % LOOP_LENGTH)};
+        if (leaves || skipped == 0) {
+            return 0;
+        }
+        system.registers[read.x()] = system.delay_timer;
+        return skipped;
+    }
+    }
+    return 0;
+}
+
 void Emulator::cycle() {
-    Instruction const instruction{getCurrentInstruction()};
+    enterBlock();
+    step();
+}
+
+void Emulator::step() {
+    DecodedInstruction const& decoded{
+        block_cache.at(active_block).instructions[block_position++]};
+
+#ifdef CHIP8_INSTRUMENTATION
+    std::uint8_t const index{InstructionSet::decode_index(decoded.instruction)};
+    instrumentation.count(index, system.program_counter);
+    if (instrumentation.sample()) {
+        system.program_counter += 2;
+        ++instruction_count;
+
+        std::uint64_t const start{Instrumentation::timestamp()};
+        (system.*decoded.execute)(decoded.instruction);
+        instrumentation.time(index, Instrumentation::timestamp() - start);
+        if (system.fault != Fault::NONE) [[unlikely]] {
+            throwFault();
+        }
+        return;
+    }
+#endif
 
     system.program_counter += 2;
+    ++instruction_count;
+
+    (system.*decoded.execute)(decoded.instruction);
+
+    if (system.fault != Fault::NONE) [[unlikely]] {
+        throwFault();
+    }
+}
+
+void Emulator::throwFault() {
+    Fault const fault{system.fault};
+    system.fault = Fault::NONE;
+
+    // The program counter has already moved past the faulting instruction
+    std::uint16_t const address{static_cast<std::uint16_t>(system.program_counter - 2)};
+    throw std::runtime_error{
+        std::format("Error: stack {} at 0x{:03X}",
+                    fault == Fault::STACK_OVERFLOW ? "overflow" : "underflow", address)};
+}
+
+/**
+ * @brief Whether two systems are in the same architectural state, used to verify compiled code.
+ */
+static bool same_state(System const& lhs, System const& rhs) {
+    return lhs.memory == rhs.memory && lhs.program_counter == rhs.program_counter &&
+           lhs.index_register == rhs.index_register && lhs.stack == rhs.stack &&
+           lhs.stack_depth == rhs.stack_depth && lhs.fault == rhs.fault &&
+           lhs.delay_timer == rhs.delay_timer && lhs.sound_timer == rhs.sound_timer &&
+           lhs.registers == rhs.registers && lhs.keys == rhs.keys &&
+           lhs.key_released == rhs.key_released && lhs.waiting == rhs.waiting &&
+           lhs.display == rhs.display && lhs.dirty_pages == rhs.dirty_pages &&
+           lhs.events == rhs.events && lhs.random() == rhs.random();
+}
+
+void Emulator::runNative(std::uint16_t const address, Block const& block) {
+    NativeBlock native{block.native};
+
+#ifdef CHIP8_INSTRUMENTATION
+    for (std::size_t idx{0}; idx < block.instructions.size(); ++idx) {
+        instrumentation.count(InstructionSet::decode_index(block.instructions[idx].instruction),
+                              static_cast<std::uint16_t>(address + (2 * idx)));
+    }
+#endif
+
+    if (native == nullptr) {
+        native = jit->compile(block, address);
+
+        if (native == nullptr) {
+            // Arena is full, so start over, recompiling blocks as they are next executed
+            block_cache.clear_native();
+            jit->reset();
+            native = jit->compile(block, address);
+        }
+
+        block_cache.set_native(address, native);
+    }
+
+    if (backend != Backend::JIT_VERIFY) {
+        native(&system);
+        return;
+    }
+
+    System shadow{system};
+
+    native(&system);
+
+    for (DecodedInstruction const& decoded : block.instructions) {
+        shadow.program_counter += 2;
+        (shadow.*decoded.execute)(decoded.instruction);
+    }
+
+    if (!same_state(system, shadow)) {
+        throw std::runtime_error{
+            std::format("Error: JIT state mismatch after block at 0x{:04X}", address)};
+    }
+}
+
+void Emulator::run(std::size_t cycles) {
+    while (cycles > 0) {
+        if (backend != Backend::INTERPRETER) {
+            syncCache();
+
+            std::uint16_t const address{system.program_counter};
+            Block const& block{block_cache.fetch(system, address, *handlers)};
+
+            if (skip_idle && block.idle != IdleLoop::NONE) {
+                if (std::size_t const skipped{skipIdle(block, cycles)}; skipped != 0) {
+                    cycles -= skipped;
+                    instruction_count += skipped;
+                    active_block = NO_BLOCK;
+                    continue;
+                }
+            }
+
+            // Only whole blocks can run natively, so the tail is left to the interpreter
+            if (block.instructions.size() <= cycles) {
+                runNative(address, block);
+                cycles -= block.instructions.size();
+                instruction_count += block.instructions.size();
+                active_block = NO_BLOCK;
+
+                // Only the last instruction of a block can fault, as calls and returns end blocks
+                if (system.fault != Fault::NONE) [[unlikely]] {
+                    throwFault();
+                }
+                continue;
+            }
+        }
+
+        // Idle loops are recognised on entering the block they start with
+        if (enterBlock() && skip_idle) {
+            if (std::size_t const skipped{skipIdle(block_cache.at(active_block), cycles)};
+                skipped != 0) {
+                cycles -= skipped;
+                instruction_count += skipped;
+                continue;
+            }
+        }
+
+        step();
+        --cycles;
+    }
+}
+
+bool Emulator::runFrame() {
+    run(config.tick_rate);
 
-    decodeInstruction(instruction);
+    return updateTimers();
 }
 } // namespace Chip8
\ No newline at end of file
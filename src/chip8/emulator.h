@@ -1,25 +1,177 @@
 #ifndef CHIP8_EMULATOR_H
 #define CHIP8_EMULATOR_H
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "block_cache.h"
+#include "config.h"
 #include "instruction.h"
+#include "instruction_set.h"
+#include "jit.h"
+#include "save_state.h"
 #include "system.h"
 
+#ifdef CHIP8_INSTRUMENTATION
+#include "instrumentation.h"
+#endif
+
 namespace Chip8 {
+/**
+ * @brief Execution backend used by Emulator::run.
+ *
+ * INTERPRETER executes decoded instructions one at a time. JIT executes natively compiled blocks
+ * where they fit in the remaining cycles, falling back to the interpreter otherwise. JIT_VERIFY
+ * additionally re-executes every compiled block with the interpreter on a copy of the system, and
+ * throws if the resulting states differ.
+ */
+enum class Backend : std::uint8_t {
+    INTERPRETER,
+    JIT,
+    JIT_VERIFY,
+};
+
 class Emulator {
+private:
+    static constexpr std::uint16_t NO_BLOCK{0xFFFF};
+
+    BlockCache block_cache;
+    // Start address of the block being executed, and position of the next instruction in it
+    std::uint16_t active_block{NO_BLOCK};
+    std::size_t block_position{0};
+
+    Config config;
+    // Instruction functions specialised for the configured quirks
+    InstructionSet::HandlerTable const* handlers;
+
+    Backend backend{Backend::INTERPRETER};
+    std::unique_ptr<Jit> jit;
+
+    // Instructions executed since construction, the clock that input is recorded against
+    std::uint64_t instruction_count{0};
+
+    bool skip_idle{true};
+
+#ifdef CHIP8_INSTRUMENTATION
+    Instrumentation instrumentation;
+#endif
+
+    void syncCache();
+    /**
+     * @brief Switch to the block at the program counter unless still in the active one, returning
+     * whether it switched.
+     */
+    bool enterBlock();
+    /** @brief Execute the next instruction of the active block. */
+    void step();
+    /**
+     * @brief Skip iterations of an idle loop starting with a block, returning how many cycles
+     * were skipped. Only whole iterations are skipped, so the state is exactly as if they had
+     * been executed.
+     */
+    std::size_t skipIdle(Block const& block, std::size_t cycles) noexcept;
+    /** @brief Throw for the fault raised by the last instruction executed, clearing it. */
+    [[noreturn]] void throwFault();
+    void runNative(std::uint16_t address, Block const& block);
+
 public:
-    Emulator();
+    explicit Emulator(Config const& config = Config::super_chip());
+
+    [[nodiscard]] Config const& getConfig() const noexcept { return config; }
 
     System system{};
 
     void decodeInstruction(Instruction instruction);
 
+    /** @brief Load a ROM from a file. Throws if it cannot be read or does not fit in memory. */
     void loadRom(std::string_view filename);
 
+    /**
+     * @brief Load a ROM which is already in memory, such as one shared between emulators. Throws
+     * if it does not fit in memory above System::PROGRAM_START.
+     */
+    void loadRom(std::span<std::uint8_t const> rom);
+
+    /**
+     * @brief Count down the timers, ending a 60hz frame. Raises SOUND_OFF when the sound timer runs
+     * out, then FRAME_READY. Returns whether the sound timer is active.
+     */
     bool updateTimers() noexcept;
 
     [[nodiscard]] Instruction getCurrentInstruction() const;
 
+    [[nodiscard]] std::uint64_t getInstructionCount() const noexcept { return instruction_count; }
+
+#ifdef CHIP8_INSTRUMENTATION
+    /**
+     * @brief Execution statistics. Instructions in natively compiled blocks are counted, but not
+     * timed.
+     */
+    [[nodiscard]] InstrumentationStats const& getStats() const noexcept {
+        return instrumentation.snapshot();
+    }
+
+    void resetStats() noexcept { instrumentation.reset(); }
+#endif
+
+    /** @brief Press or release a key, completing any wait for a key release. */
+    void setKey(std::uint8_t key, bool pressed);
+
+    /**
+     * @brief Drop all decoded instructions. Must be called after writing to system memory from
+     * outside of instruction execution, unless the written pages are marked in dirty_pages.
+     */
+    void invalidateCache();
+
+    /**
+     * @brief Select the backend used by run. Throws if a JIT backend is selected on a host which
+     * does not support it.
+     */
+    void setBackend(Backend backend);
+
+    [[nodiscard]] Backend getBackend() const noexcept { return backend; }
+
+    /**
+     * @brief Select whether run skips over idle loops, such as a jump to itself or a wait for a
+     * key, which cannot make progress until the host next updates the timers or keys. Enabled by
+     * default. The result is identical either way, so this only matters for measuring execution.
+     */
+    void setIdleSkipping(bool const enabled) noexcept { skip_idle = enabled; }
+
+    /** @brief Capture the machine state, cheaply enough to checkpoint every frame. */
+    void saveState(SaveState& state) const;
+    [[nodiscard]] SaveState saveState() const;
+    void saveState(std::string_view filename) const;
+
+    /**
+     * @brief Restore a previously saved machine state. The configuration and backend are kept, so
+     * should match those the state was saved with.
+     */
+    void loadState(SaveState const& state);
+    void loadState(std::span<std::byte const> bytes);
+    void loadState(std::string_view filename);
+
+    /**
+     * @brief Execute a single instruction. Always interpreted. Throws if the instruction faults,
+     * such as by calling with a full stack or returning with an empty one.
+     */
     void cycle();
+
+    /**
+     * @brief Execute exactly the given number of instructions, using the selected backend, and
+     * skipping over idle loops unless disabled. Throws if an instruction faults, with the
+     * instructions before it executed.
+     */
+    void run(std::size_t cycles);
+
+    /**
+     * @brief Execute one 60hz frame: the configured number of instructions, followed by a timer
+     * update. Returns whether the sound timer is active.
+     */
+    bool runFrame();
 };
 } // namespace Chip8
 #endif // CHIP8_EMULATOR_H
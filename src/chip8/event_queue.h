@@ -0,0 +1,87 @@
+#ifndef CHIP8_EVENT_QUEUE_H
+#define CHIP8_EVENT_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace Chip8 {
+/** @brief Something which happened during execution that the host may need to act on. */
+enum class Event : std::uint8_t {
+    EXIT,        // the program ran the SUPER-CHIP exit instruction
+    LORES,       // the display changed to low resolution
+    HIRES,       // the display changed to high resolution
+    SOUND_ON,    // the sound timer became active
+    SOUND_OFF,   // the sound timer ran out, or was cleared
+    FRAME_READY, // a 60hz frame ended with a timer update
+};
+
+/**
+ * @brief Fixed capacity ring buffer of events, appended to by instructions and drained by the host
+ * between batches of instructions, so execution never calls into the host. Repeats of the most
+ * recent undrained event are coalesced, so a host draining once per frame only loses events to a
+ * program alternating between them, in which case further events are dropped and counted.
+ */
+class EventQueue {
+public:
+    static constexpr std::uint8_t CAPACITY{32};
+
+private:
+    std::array<Event, CAPACITY> events{};
+    std::uint8_t head{0}; // index of the oldest event
+    std::uint8_t count{0};
+    std::uint32_t dropped_count{0};
+
+public:
+    void push(Event const event) noexcept {
+        if (count != 0 && events[(head + count - 1) % CAPACITY] == event) {
+            return;
+        }
+        if (count == CAPACITY) [[unlikely]] {
+            ++dropped_count;
+            return;
+        }
+
+        events[(head + count) % CAPACITY] = event;
+        ++count;
+    }
+
+    /** @brief Take the oldest event, if there is one. */
+    [[nodiscard]] std::optional<Event> pop() noexcept {
+        if (count == 0) {
+            return std::nullopt;
+        }
+
+        Event const event{events[head]};
+        head = (head + 1) % CAPACITY;
+        --count;
+        return event;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+    [[nodiscard]] std::uint8_t size() const noexcept { return count; }
+
+    /** @brief Number of events dropped because the queue was full. */
+    [[nodiscard]] std::uint32_t dropped() const noexcept { return dropped_count; }
+
+    /** @brief Whether two queues hold the same events and have dropped as many. */
+    bool operator==(EventQueue const& other) const noexcept {
+        if (count != other.count || dropped_count != other.dropped_count) {
+            return false;
+        }
+        for (std::uint8_t idx{0}; idx < count; ++idx) {
+            if (events[(head + idx) % CAPACITY] !=
+                other.events[(other.head + idx) % CAPACITY]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void clear() noexcept {
+        head = 0;
+        count = 0;
+    }
+};
+} // namespace Chip8
+#endif // CHIP8_EVENT_QUEUE_H
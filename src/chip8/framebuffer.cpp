@@ -0,0 +1,152 @@
+#include "framebuffer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Chip8 {
+Framebuffer::Framebuffer(std::uint8_t const width, std::uint8_t const height) noexcept {
+    resize(width, height);
+}
+
+void Framebuffer::resize(std::uint8_t const width, std::uint8_t const height) noexcept {
+    current_width = std::min(width, MAX_WIDTH);
+    current_height = std::min(height, MAX_HEIGHT);
+
+    for (std::uint8_t word{0}; word < ROW_WORDS; ++word) {
+        std::uint8_t const start{static_cast<std::uint8_t>(word * WORD_BITS)};
+        std::uint8_t const bits{static_cast<std::uint8_t>(
+            std::clamp<int>(current_width - start, 0, WORD_BITS))};
+
+        visible[word] = bits == 0            ? 0
+                        : bits == WORD_BITS ? ~std::uint64_t{0}
+                                            : ~std::uint64_t{0} << (WORD_BITS - bits);
+    }
+
+    for (std::uint8_t y{0}; y < MAX_HEIGHT; ++y) {
+        for (std::uint8_t word{0}; word < ROW_WORDS; ++word) {
+            rows[y][word] = y < current_height ? rows[y][word] & visible[word] : 0;
+        }
+    }
+
+    dirty_rows = ALL_ROWS;
+}
+
+void Framebuffer::set_pixel(std::uint8_t const x, std::uint8_t const y, bool const value) noexcept {
+    std::uint64_t const bit{std::uint64_t{1} << (WORD_BITS - 1 - (x % WORD_BITS))};
+
+    if (value) {
+        rows[y][x / WORD_BITS] |= bit;
+    } else {
+        rows[y][x / WORD_BITS] &= ~bit;
+    }
+
+    dirty_rows |= std::uint64_t{1} << y;
+}
+
+bool Framebuffer::draw_row(std::uint8_t const x, std::uint8_t const y, std::uint16_t const sprite,
+                           std::uint8_t const sprite_width) noexcept {
+    // Left align the sprite within a word, then shift it along the row to its column
+    std::uint64_t const aligned{static_cast<std::uint64_t>(sprite) << (WORD_BITS - sprite_width)};
+
+    Row shifted{};
+    if (x < WORD_BITS) {
+        shifted[0] = aligned >> x;
+        shifted[1] = x == 0 ? 0 : aligned << (WORD_BITS - x);
+    } else {
+        shifted[1] = aligned >> (x - WORD_BITS);
+    }
+
+    Row& target{rows[y]};
+    bool collision{false};
+    bool changed{false};
+    for (std::uint8_t word{0}; word < ROW_WORDS; ++word) {
+        std::uint64_t const clipped{shifted[word] & visible[word]};
+
+        collision |= (target[word] & clipped) != 0;
+        changed |= clipped != 0;
+        target[word] ^= clipped;
+    }
+
+    if (changed) {
+        dirty_rows |= std::uint64_t{1} << y;
+    }
+
+    return collision;
+}
+
+void Framebuffer::scroll_down(std::uint8_t const n) noexcept {
+    std::uint8_t const distance{std::min(n, current_height)};
+
+    if (distance == 0) {
+        return;
+    }
+
+    // Move rows down from the bottom up, so no row is overwritten before it is moved
+    std::copy_backward(rows.begin(), rows.begin() + (current_height - distance),
+                       rows.begin() + current_height);
+    std::fill(rows.begin(), rows.begin() + distance, Row{});
+
+    dirty_rows |= current_rows();
+}
+
+void Framebuffer::scroll_right(std::uint8_t const n) noexcept {
+    if (n == 0 || n >= WORD_BITS) {
+        return;
+    }
+
+    for (std::uint8_t y{0}; y < current_height; ++y) {
+        Row& row{rows[y]};
+
+        row[1] = (row[1] >> n) | (row[0] << (WORD_BITS - n));
+        row[0] >>= n;
+        row[0] &= visible[0];
+        row[1] &= visible[1];
+    }
+
+    dirty_rows |= current_rows();
+}
+
+void Framebuffer::scroll_left(std::uint8_t const n) noexcept {
+    if (n == 0 || n >= WORD_BITS) {
+        return;
+    }
+
+    for (std::uint8_t y{0}; y < current_height; ++y) {
+        Row& row{rows[y]};
+
+        row[0] = (row[0] << n) | (row[1] >> (WORD_BITS - n));
+        row[1] <<= n;
+        row[0] &= visible[0];
+        row[1] &= visible[1];
+    }
+
+    dirty_rows |= current_rows();
+}
+
+std::uint64_t Framebuffer::hash() const noexcept {
+    constexpr std::uint64_t FNV_OFFSET_BASIS{0xCBF29CE484222325};
+    constexpr std::uint64_t FNV_PRIME{0x100000001B3};
+
+    std::uint64_t hash{FNV_OFFSET_BASIS};
+    auto const add_byte{[&hash](std::uint8_t const byte) {
+        hash ^= byte;
+        hash *= FNV_PRIME;
+    }};
+
+    add_byte(current_width);
+    add_byte(current_height);
+    for (std::uint8_t y{0}; y < current_height; ++y) {
+        for (std::uint8_t word{0}; word < ROW_WORDS; ++word) {
+            if (visible[word] == 0) {
+                continue;
+            }
+            // Most significant byte first, so bytes follow pixels left to right
+            for (int shift{WORD_BITS - 8}; shift >= 0; shift -= 8) {
+                add_byte(static_cast<std::uint8_t>(rows[y][word] >> shift));
+            }
+        }
+    }
+
+    return hash;
+}
+} // namespace Chip8
@@ -0,0 +1,114 @@
+#ifndef CHIP8_FRAMEBUFFER_H
+#define CHIP8_FRAMEBUFFER_H
+
+#include <array>
+#include <cstdint>
+
+namespace Chip8 {
+/**
+ * @brief Monochrome framebuffer, storing each row as bits packed into 64-bit words, with the
+ * leftmost pixel in the most significant bit of the first word. Storage is fixed at the largest
+ * resolution, with the current resolution occupying the top left of it, so changing resolution
+ * never allocates.
+ */
+class Framebuffer {
+public:
+    static constexpr std::uint8_t MAX_WIDTH{128};
+    static constexpr std::uint8_t MAX_HEIGHT{64};
+    static constexpr std::uint8_t WORD_BITS{64};
+    static constexpr std::uint8_t ROW_WORDS{MAX_WIDTH / WORD_BITS};
+
+    using Row = std::array<std::uint64_t, ROW_WORDS>;
+
+    static constexpr std::uint64_t ALL_ROWS{~std::uint64_t{0}};
+    static_assert(MAX_HEIGHT <= 64, "Dirty rows are tracked in a single 64-bit mask");
+
+private:
+    std::array<Row, MAX_HEIGHT> rows{};
+    Row visible{}; // mask of the bits of each row within the current width
+    std::uint8_t current_width{0};
+    std::uint8_t current_height{0};
+    // Explicit padding, so that every byte of a framebuffer, and so of a save state, is defined
+    std::array<std::uint8_t, 6> reserved{};
+
+    // Rows changed since last taken, where bit N represents row N
+    std::uint64_t dirty_rows{ALL_ROWS};
+
+    [[nodiscard]] std::uint64_t current_rows() const noexcept {
+        return current_height == MAX_HEIGHT ? ALL_ROWS
+                                            : (std::uint64_t{1} << current_height) - 1;
+    }
+
+public:
+    Framebuffer(std::uint8_t width, std::uint8_t height) noexcept;
+
+    [[nodiscard]] std::uint8_t width() const noexcept { return current_width; }
+    [[nodiscard]] std::uint8_t height() const noexcept { return current_height; }
+
+    /**
+     * @brief Change resolution. Pixels within both resolutions are kept, while any outside of the
+     * new resolution are cleared.
+     */
+    void resize(std::uint8_t width, std::uint8_t height) noexcept;
+
+    [[nodiscard]] bool pixel(std::uint8_t const x, std::uint8_t const y) const noexcept {
+        return ((rows[y][x / WORD_BITS] >> (WORD_BITS - 1 - (x % WORD_BITS))) & 1) != 0;
+    }
+
+    void set_pixel(std::uint8_t x, std::uint8_t y, bool value) noexcept;
+
+    [[nodiscard]] Row const& row(std::uint8_t const y) const noexcept { return rows[y]; }
+
+    void clear() noexcept {
+        rows = {};
+        dirty_rows = ALL_ROWS;
+    }
+
+    /**
+     * @brief Get the mask of rows changed since the last call, where bit N represents row N, and
+     * reset it. A renderer only needs to update these rows, and nothing when the mask is zero.
+     */
+    [[nodiscard]] std::uint64_t take_dirty_rows() noexcept {
+        std::uint64_t const dirty{dirty_rows};
+        dirty_rows = 0;
+        return dirty;
+    }
+
+    /** @brief Mark every row as changed, such as when a renderer loses its copy of the display. */
+    void mark_all_dirty() noexcept { dirty_rows = ALL_ROWS; }
+
+    /**
+     * @brief XOR a row of sprite data onto the framebuffer, with its leftmost pixel at (x, y).
+     * The sprite is given in the low sprite_width bits, most significant bit leftmost, and is
+     * clipped at the right edge. Returns whether any pixel was turned off (a collision).
+     */
+    bool draw_row(std::uint8_t x, std::uint8_t y, std::uint16_t sprite,
+                  std::uint8_t sprite_width) noexcept;
+
+    /**
+     * @brief Scroll the rows of the current resolution down by n rows, in place, as a single
+     * bulk move of whole rows. Scrolling by the height or more clears the framebuffer.
+     */
+    void scroll_down(std::uint8_t n) noexcept;
+
+    /**
+     * @brief Scroll the rows of the current resolution horizontally by n pixels, in place, by
+     * shifting each row's words. Supports distances of less than a word.
+     */
+    void scroll_right(std::uint8_t n) noexcept;
+    void scroll_left(std::uint8_t n) noexcept;
+
+    /**
+     * @brief Compute a 64-bit FNV-1a hash of the resolution and the visible pixels, to compare
+     * the output of runs without storing whole framebuffers.
+     */
+    [[nodiscard]] std::uint64_t hash() const noexcept;
+
+    /** @brief Compare resolution and pixels, ignoring which rows are dirty. */
+    bool operator==(Framebuffer const& other) const noexcept {
+        return rows == other.rows && current_width == other.current_width &&
+               current_height == other.current_height;
+    }
+};
+} // namespace Chip8
+#endif // CHIP8_FRAMEBUFFER_H
@@ -0,0 +1,178 @@
+#include "input_log.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "emulator.h"
+
+namespace Chip8 {
+namespace {
+void put_integer(std::vector<std::uint8_t>& out, std::uint64_t value, std::size_t const bytes) {
+    for (std::size_t i{0}; i < bytes; ++i) {
+        out.push_back(static_cast<std::uint8_t>(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+// LEB128, as most events are only a few frames apart
+void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+class Reader {
+private:
+    std::span<std::uint8_t const> bytes;
+    std::size_t position{0};
+
+public:
+    explicit Reader(std::span<std::uint8_t const> const bytes) : bytes{bytes} {}
+
+    [[nodiscard]] bool done() const noexcept { return position == bytes.size(); }
+
+    std::uint8_t byte() {
+        if (done()) {
+            throw std::runtime_error{"Error: input log is truncated"};
+        }
+        return bytes[position++];
+    }
+
+    std::uint64_t integer(std::size_t const count) {
+        std::uint64_t value{0};
+        for (std::size_t i{0}; i < count; ++i) {
+            value |= static_cast<std::uint64_t>(byte()) << (8 * i);
+        }
+        return value;
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value{0};
+        for (std::size_t shift{0}; shift < 64; shift += 7) {
+            std::uint8_t const next{byte()};
+            value |= static_cast<std::uint64_t>(next & 0x7F) << shift;
+            if ((next & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error{"Error: input log is corrupt"};
+    }
+};
+} // namespace
+
+std::vector<std::uint8_t> InputLog::serialise() const {
+    std::vector<std::uint8_t> out{MAGIC.begin(), MAGIC.end()};
+    put_integer(out, VERSION, 2);
+
+    out.push_back(config.shift_quirk);
+    out.push_back(config.jump_quirk);
+    out.push_back(config.memory_quirk);
+    out.push_back(config.vblank_quirk);
+    out.push_back(config.max_width);
+    out.push_back(config.max_height);
+    put_integer(out, config.tick_rate, 2);
+
+    put_integer(out, seed, 4);
+    put_integer(out, instructions, 8);
+
+    std::uint64_t previous{0};
+    for (InputEvent const& event : events) {
+        put_varint(out, event.instruction - previous);
+        out.push_back(static_cast<std::uint8_t>((event.key << 1) | (event.pressed ? 1 : 0)));
+        previous = event.instruction;
+    }
+    return out;
+}
+
+InputLog InputLog::deserialise(std::span<std::uint8_t const> const bytes) {
+    Reader reader{bytes};
+
+    for (char const expected : MAGIC) {
+        if (reader.byte() != static_cast<std::uint8_t>(expected)) {
+            throw std::runtime_error{"Error: not an input log"};
+        }
+    }
+    if (reader.integer(2) != VERSION) {
+        throw std::runtime_error{"Error: input log is from an incompatible version"};
+    }
+
+    InputLog log{};
+    log.config.shift_quirk = reader.byte() != 0;
+    log.config.jump_quirk = reader.byte() != 0;
+    log.config.memory_quirk = reader.byte() != 0;
+    log.config.vblank_quirk = reader.byte() != 0;
+    log.config.max_width = reader.byte();
+    log.config.max_height = reader.byte();
+    log.config.tick_rate = static_cast<std::uint16_t>(reader.integer(2));
+
+    log.seed = static_cast<std::uint32_t>(reader.integer(4));
+    log.instructions = reader.integer(8);
+
+    std::uint64_t instruction{0};
+    while (!reader.done()) {
+        instruction += reader.varint();
+        std::uint8_t const packed{reader.byte()};
+        if ((packed >> 1) >= System::NUM_KEYS) {
+            throw std::runtime_error{"Error: input log is corrupt"};
+        }
+        log.record(instruction, packed >> 1, (packed & 1) != 0);
+    }
+    return log;
+}
+
+void InputLog::write(std::string_view const filename) const {
+    std::string const path{filename};
+    std::vector<std::uint8_t> const bytes{serialise()};
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.write(reinterpret_cast<char const*>(bytes.data()),
+                    static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error{"Error: could not write input log " + path};
+    }
+}
+
+InputLog InputLog::read(std::string_view const filename) {
+    std::string const path{filename};
+
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        throw std::runtime_error{"Error: could not read input log " + path};
+    }
+    std::vector<std::uint8_t> const bytes{std::istreambuf_iterator<char>{file},
+                                          std::istreambuf_iterator<char>{}};
+    return deserialise(bytes);
+}
+
+void InputPlayer::applyDue(Emulator& emulator) {
+    while (next_event < log.events.size() &&
+           log.events[next_event].instruction <= emulator.getInstructionCount()) {
+        InputEvent const& event{log.events[next_event++]};
+        emulator.setKey(event.key, event.pressed);
+    }
+}
+
+void InputPlayer::run(Emulator& emulator, std::uint64_t cycles) {
+    while (cycles > 0) {
+        applyDue(emulator);
+
+        std::uint64_t step{cycles};
+        if (next_event < log.events.size()) {
+            step = std::min(step, log.events[next_event].instruction -
+                                      emulator.getInstructionCount());
+        }
+
+        emulator.run(step);
+        cycles -= step;
+    }
+    applyDue(emulator);
+}
+} // namespace Chip8
@@ -0,0 +1,69 @@
+#ifndef CHIP8_INPUT_LOG_H
+#define CHIP8_INPUT_LOG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "config.h"
+#include "emulator.h"
+
+namespace Chip8 {
+/** @brief A key press or release, applied before the given instruction count was executed. */
+struct InputEvent {
+    std::uint64_t instruction{0};
+    std::uint8_t key{0};
+    bool pressed{false};
+
+    bool operator==(InputEvent const&) const = default;
+};
+
+/**
+ * @brief Everything needed to reproduce a run exactly: the configuration, the random seed, and
+ * every key edge stamped with the instruction count it happened at. Stored compactly, with each
+ * event as the instruction count since the previous event, followed by the key and its state.
+ */
+struct InputLog {
+    static constexpr std::array<char, 4> MAGIC{'C', '8', 'I', 'L'};
+    static constexpr std::uint16_t VERSION{1};
+
+    Config config{};
+    std::uint32_t seed{0};
+    // Instructions executed over the whole recording
+    std::uint64_t instructions{0};
+    std::vector<InputEvent> events;
+
+    void record(std::uint64_t const instruction, std::uint8_t const key, bool const pressed) {
+        events.push_back({.instruction = instruction, .key = key, .pressed = pressed});
+    }
+
+    [[nodiscard]] std::vector<std::uint8_t> serialise() const;
+    /** @brief Read a serialised log, throwing if it is truncated or of another format. */
+    [[nodiscard]] static InputLog deserialise(std::span<std::uint8_t const> bytes);
+
+    void write(std::string_view filename) const;
+    [[nodiscard]] static InputLog read(std::string_view filename);
+};
+
+/** @brief Replays an input log into an emulator, as it executes. */
+class InputPlayer {
+private:
+    InputLog const& log;
+    std::size_t next_event{0};
+
+    void applyDue(Emulator& emulator);
+
+public:
+    explicit InputPlayer(InputLog const& log) : log{log} {}
+
+    /**
+     * @brief Execute exactly the given number of instructions, stopping at each logged event to
+     * apply it at the instruction count it was recorded at.
+     */
+    void run(Emulator& emulator, std::uint64_t cycles);
+};
+} // namespace Chip8
+#endif // CHIP8_INPUT_LOG_H
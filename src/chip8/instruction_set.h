@@ -1,8 +1,12 @@
 #ifndef CHIP8_INSTRUCTION_SET_H
 #define CHIP8_INSTRUCTION_SET_H
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+#include "config.h"
 #include "system.h"
 
 namespace Chip8::InstructionSet {
@@ -92,8 +96,11 @@ constexpr OpcodeFunction opcode_third_nibble(std::uint8_t const high_nibble,
 
 /**
  * @brief Instruction set decode table. Represents a mapping between instructions and functions
- * that should be executed by the chip8 system.
+ * that should be executed by the chip8 system. Instructions affected by quirks map to functions
+ * specialised for the given quirk policy, so the rows of every instantiation are in the same
+ * order, and differ only in those functions.
  */
+template <typename Quirks>
 static constexpr std::array DECODE_TABLE{
     opcode_third_nibble(0x0, 0xC, &System::sc_down),
     opcode_low_byte(0x0, 0xE0, &System::cls),
@@ -116,12 +123,12 @@ static constexpr std::array DECODE_TABLE{
     opcode_low_nibble(0x8, 0x3, &System::xor_vx_vy),
     opcode_low_nibble(0x8, 0x4, &System::add_vx_vy),
     opcode_low_nibble(0x8, 0x5, &System::sub_vx_vy),
-    opcode_low_nibble(0x8, 0x6, &System::shr_vx_vy),
+    opcode_low_nibble(0x8, 0x6, &System::shr_vx_vy<Quirks::SHIFT>),
     opcode_low_nibble(0x8, 0x7, &System::rsb_vx_vy),
-    opcode_low_nibble(0x8, 0xE, &System::shl_vx_vy),
+    opcode_low_nibble(0x8, 0xE, &System::shl_vx_vy<Quirks::SHIFT>),
     opcode_standard(0x9, &System::sne_vx_vy),
     opcode_standard(0xA, &System::mov_i_nnn),
-    opcode_standard(0xB, &System::jmp_vx_nnn),
+    opcode_standard(0xB, &System::jmp_vx_nnn<Quirks::JUMP>),
     opcode_standard(0xC, &System::rnd_vx_nn),
     opcode_standard(0xD, &System::drw),
     opcode_low_byte(0xE, 0x9E, &System::spr_vx),
@@ -134,8 +141,126 @@ static constexpr std::array DECODE_TABLE{
     opcode_low_byte(0xF, 0x29, &System::mov_i_font_vx),
     opcode_low_byte(0xF, 0x30, &System::mov_i_bfont_vx),
     opcode_low_byte(0xF, 0x33, &System::mov_i_bcd_vx),
-    opcode_low_byte(0xF, 0x55, &System::mov_i_vx),
-    opcode_low_byte(0xF, 0x65, &System::mov_vx_i),
+    opcode_low_byte(0xF, 0x55, &System::mov_i_vx<Quirks::MEMORY>),
+    opcode_low_byte(0xF, 0x65, &System::mov_vx_i<Quirks::MEMORY>),
 };
+
+/**
+ * @brief Number of entries in the dispatch table. No opcode is differentiated by its second
+ * nibble (which always holds the X operand), so an instruction is identified by its high nibble
+ * and low byte alone, giving 0x10 x 0x100 possible keys.
+ */
+static constexpr std::size_t DISPATCH_SIZE{0x1000};
+
+/**
+ * @brief Index of the invalid instruction handler in HANDLERS, used by the dispatch table for
+ * every key which does not match a row of the decode table.
+ */
+static constexpr std::uint8_t INVALID_INDEX{DECODE_TABLE<Chip8Quirks>.size()};
+
+/**
+ * @brief Compute the dispatch table key of an instruction, by concatenating its high nibble and
+ * its low byte.
+ */
+[[nodiscard]] constexpr std::uint16_t dispatch_key(Instruction const instruction) {
+    constexpr std::uint16_t HIGH_NIBBLE_MASK{0xF000};
+    constexpr std::uint16_t LOW_BYTE_MASK{0x00FF};
+    constexpr std::uint8_t SHIFT{4};
+
+    return ((instruction.raw_data() & HIGH_NIBBLE_MASK) >> SHIFT) |
+           (instruction.raw_data() & LOW_BYTE_MASK);
+}
+
+static_assert(std::ranges::all_of(DECODE_TABLE<Chip8Quirks>,
+                                  [](OpcodeFunction const& row) {
+                                      constexpr std::uint16_t SECOND_NIBBLE_MASK{0x0F00};
+                                      return (row.mask & SECOND_NIBBLE_MASK) == 0;
+                                  }),
+              "Dispatch keys do not include the second nibble, so no opcode may depend on it");
+
+/**
+ * @brief Dispatch table, generated at compile time from the decode table. Maps every dispatch
+ * key to the index of the first matching row of DECODE_TABLE (matching the order the table was
+ * previously scanned in), or INVALID_INDEX when no row matches. Matching does not depend on the
+ * quirk policy, so a single dispatch table serves every policy.
+ */
+static constexpr std::array<std::uint8_t, DISPATCH_SIZE> DISPATCH_TABLE{[] {
+    std::array<std::uint8_t, DISPATCH_SIZE> table{};
+
+    for (std::size_t key{0}; key < DISPATCH_SIZE; ++key) {
+        // Rebuild an instruction with a zero second nibble from the key
+        Instruction const instruction{
+            static_cast<std::uint16_t>(((key & 0xF00) << 4) | (key & 0xFF))};
+
+        table.at(key) = INVALID_INDEX;
+        for (std::size_t idx{0}; idx < DECODE_TABLE<Chip8Quirks>.size(); ++idx) {
+            if (DECODE_TABLE<Chip8Quirks>.at(idx).matches(instruction)) {
+                table.at(key) = static_cast<std::uint8_t>(idx);
+                break;
+            }
+        }
+    }
+
+    return table;
+}()};
+
+/**
+ * @brief Table of instruction functions, indexed by the values of the dispatch table.
+ */
+using HandlerTable = std::array<InstructionFunctionPtr, INVALID_INDEX + 1>;
+
+/**
+ * @brief Instruction functions for a quirk policy, indexed by the values of the dispatch table.
+ * Holds the function of each row of DECODE_TABLE, followed by the invalid instruction handler at
+ * INVALID_INDEX.
+ */
+template <typename Quirks>
+static constexpr HandlerTable HANDLERS{[] {
+    HandlerTable handlers{};
+
+    for (std::size_t idx{0}; idx < DECODE_TABLE<Quirks>.size(); ++idx) {
+        handlers.at(idx) = DECODE_TABLE<Quirks>.at(idx).execute;
+    }
+    handlers.at(INVALID_INDEX) = &System::invalid;
+
+    return handlers;
+}()};
+
+/**
+ * @brief Handler tables for every combination of quirks, indexed by a bitmask of the shift (bit
+ * 2), jump (bit 1) and memory (bit 0) quirks.
+ */
+static constexpr std::array<HandlerTable const*, 8> QUIRK_HANDLERS{
+    &HANDLERS<QuirkPolicy<false, false, false>>, &HANDLERS<QuirkPolicy<false, false, true>>,
+    &HANDLERS<QuirkPolicy<false, true, false>>,  &HANDLERS<QuirkPolicy<false, true, true>>,
+    &HANDLERS<QuirkPolicy<true, false, false>>,  &HANDLERS<QuirkPolicy<true, false, true>>,
+    &HANDLERS<QuirkPolicy<true, true, false>>,   &HANDLERS<QuirkPolicy<true, true, true>>,
+};
+
+/**
+ * @brief Select the handler table specialised for a combination of quirks. Intended to be called
+ * once, when an emulator is created, so quirks are never checked during execution.
+ */
+[[nodiscard]] constexpr HandlerTable const& handlers(bool const shift_quirk, bool const jump_quirk,
+                                                     bool const memory_quirk) {
+    return *QUIRK_HANDLERS[(shift_quirk ? 0b100U : 0U) | (jump_quirk ? 0b010U : 0U) |
+                           (memory_quirk ? 0b001U : 0U)];
+}
+
+/**
+ * @brief Decode an instruction to the index of its function in a handler table in constant time.
+ */
+[[nodiscard]] constexpr std::uint8_t decode_index(Instruction const instruction) {
+    return DISPATCH_TABLE[dispatch_key(instruction)];
+}
+
+/**
+ * @brief Decode an instruction to the function which executes it for a quirk policy in constant
+ * time. Invalid instructions decode to System::invalid.
+ */
+template <typename Quirks>
+[[nodiscard]] constexpr InstructionFunctionPtr decode(Instruction const instruction) {
+    return HANDLERS<Quirks>[decode_index(instruction)];
+}
 } // namespace Chip8::InstructionSet
 #endif // CHIP8_INSTRUCTION_SET_H
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <numeric>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "config.h"
+#include "instruction_set.h"
+
+namespace Chip8 {
+namespace {
+// Names of the rows of InstructionSet::DECODE_TABLE, in order, followed by the invalid handler
+constexpr std::array<std::string_view, InstrumentationStats::HANDLER_COUNT> HANDLER_NAMES{
+    "00CN sc_down", "00E0 cls", "00EE ret", "00FB sc_right", "00FC sc_left", "00FD exit",
+    "00FE lores", "00FF hires", "1NNN jmp", "2NNN call", "3XNN seq_vx_nn", "4XNN sne_vx_nn",
+    "5XY0 seq_vx_vy", "6XNN mov_vx_nn", "7XNN add_vx_nn", "8XY0 mov_vx_vy", "8XY1 or_vx_vy",
+    "8XY2 and_vx_vy", "8XY3 xor_vx_vy", "8XY4 add_vx_vy", "8XY5 sub_vx_vy", "8XY6 shr_vx_vy",
+    "8XY7 rsb_vx_vy", "8XYE shl_vx_vy", "9XY0 sne_vx_vy", "ANNN mov_i_nnn", "BNNN jmp_vx_nnn",
+    "CXNN rnd_vx_nn", "DXYN drw", "EX9E spr_vx", "EXA1 sup_vx", "FX07 mov_vx_dt",
+    "FX0A wait_mov_vx_key", "FX15 mov_dt_vx", "FX18 mov_st_vx", "FX1E add_i_vx",
+    "FX29 mov_i_font_vx", "FX30 mov_i_bfont_vx", "FX33 mov_i_bcd_vx", "FX55 mov_i_vx",
+    "FX65 mov_vx_i", "invalid",
+};
+
+/**
+ * @brief Check every name starts with an opcode pattern matching its row of the decode table, such
+ * as "8XY4", where hex digits are fixed and letters are operands.
+ */
+constexpr bool names_match_decode_table() {
+    constexpr std::size_t NIBBLES{4};
+
+    for (std::size_t idx{0}; idx < InstructionSet::INVALID_INDEX; ++idx) {
+        InstructionSet::OpcodeFunction const& row{
+            InstructionSet::DECODE_TABLE<Chip8Quirks>.at(idx)};
+        std::string_view const name{HANDLER_NAMES.at(idx)};
+
+        std::uint16_t mask{0};
+        std::uint16_t value{0};
+        for (std::size_t nibble{0}; nibble < NIBBLES; ++nibble) {
+            char const digit{name.at(nibble)};
+            auto const shift{static_cast<std::uint16_t>(12 - (4 * nibble))};
+
+            if (digit >= '0' && digit <= '9') {
+                mask |= 0xF << shift;
+                value |= (digit - '0') << shift;
+            } else if (digit >= 'A' && digit <= 'F') {
+                mask |= 0xF << shift;
+                value |= (digit - 'A' + 0xA) << shift;
+            }
+        }
+
+        std::uint16_t const row_value{
+            static_cast<std::uint16_t>((row.high_nibble << 12) | row.low_byte)};
+        if ((mask & row.mask) != row.mask || (value & row.mask) != row_value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(names_match_decode_table(), "Handler names must be in the order of the decode table");
+} // namespace
+
+std::string_view InstrumentationStats::handler_name(std::uint8_t const index) {
+    return HANDLER_NAMES.at(index);
+}
+
+std::uint64_t InstrumentationStats::total_executions() const {
+    return std::accumulate(executions.begin(), executions.end(), std::uint64_t{0});
+}
+
+double InstrumentationStats::estimated_ticks(std::uint8_t const index) const {
+    if (samples.at(index) == 0) {
+        return 0;
+    }
+    return static_cast<double>(sampled_ticks.at(index)) / static_cast<double>(samples.at(index)) *
+           static_cast<double>(executions.at(index));
+}
+
+std::vector<InstrumentationStats::Hotspot>
+InstrumentationStats::hotspots(std::size_t const count) const {
+    std::vector<Hotspot> spots{};
+    for (std::size_t address{0}; address < address_executions.size(); ++address) {
+        if (address_executions[address] != 0) {
+            spots.push_back({.address = static_cast<std::uint16_t>(address),
+                             .executions = address_executions[address]});
+        }
+    }
+
+    std::size_t const kept{std::min(count, spots.size())};
+    std::ranges::partial_sort(spots, spots.begin() + static_cast<std::ptrdiff_t>(kept),
+                              [](Hotspot const& lhs, Hotspot const& rhs) {
+                                  return lhs.executions > rhs.executions;
+                              });
+    spots.resize(kept);
+    return spots;
+}
+
+void InstrumentationStats::merge(InstrumentationStats const& other) {
+    for (std::size_t idx{0}; idx < HANDLER_COUNT; ++idx) {
+        executions[idx] += other.executions[idx];
+        sampled_ticks[idx] += other.sampled_ticks[idx];
+        samples[idx] += other.samples[idx];
+    }
+    for (std::size_t address{0}; address < address_executions.size(); ++address) {
+        address_executions[address] += other.address_executions[address];
+    }
+}
+
+void InstrumentationStats::report(std::ostream& out, std::size_t const hotspot_count) const {
+    std::uint64_t const total{std::max<std::uint64_t>(total_executions(), 1)};
+
+    double total_ticks{0};
+    std::vector<std::uint8_t> order{};
+    for (std::size_t idx{0}; idx < HANDLER_COUNT; ++idx) {
+        total_ticks += estimated_ticks(static_cast<std::uint8_t>(idx));
+        if (executions[idx] != 0) {
+            order.push_back(static_cast<std::uint8_t>(idx));
+        }
+    }
+    std::ranges::sort(order, [this](std::uint8_t const lhs, std::uint8_t const rhs) {
+        return executions[lhs] > executions[rhs];
+    });
+
+    out << std::format("{:<22}  {:>14}  {:>7}  {:>12}  {:>7}\n", "handler", "executions",
+                       "exec %", "ticks/exec", "time %");
+    for (std::uint8_t const idx : order) {
+        double const ticks{estimated_ticks(idx)};
+        out << std::format("{:<22}  {:>14}  {:>6.2f}%  {:>12.1f}  {:>6.2f}%\n", handler_name(idx),
+                           executions[idx],
+                           100.0 * static_cast<double>(executions[idx]) /
+                               static_cast<double>(total),
+                           ticks / static_cast<double>(executions[idx]),
+                           total_ticks > 0 ? 100.0 * ticks / total_ticks : 0.0);
+    }
+
+    out << std::format("\n{:<7}  {:>14}  {:>7}\n", "address", "executions", "exec %");
+    for (Hotspot const& spot : hotspots(hotspot_count)) {
+        out << std::format("0x{:03X}    {:>14}  {:>6.2f}%\n", spot.address, spot.executions,
+                           100.0 * static_cast<double>(spot.executions) /
+                               static_cast<double>(total));
+    }
+}
+} // namespace Chip8
@@ -0,0 +1,104 @@
+#ifndef CHIP8_INSTRUMENTATION_H
+#define CHIP8_INSTRUMENTATION_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "instruction_set.h"
+#include "system.h"
+
+namespace Chip8 {
+/**
+ * @brief Execution statistics of an emulator, collected when built with the CHIP8_INSTRUMENTATION
+ * option. Handlers are identified by their index in the handler tables.
+ */
+struct InstrumentationStats {
+    static constexpr std::size_t HANDLER_COUNT{InstructionSet::INVALID_INDEX + 1};
+
+    struct Hotspot {
+        std::uint16_t address;
+        std::uint64_t executions;
+    };
+
+    std::array<std::uint64_t, HANDLER_COUNT> executions{};
+    // Timestamp counter ticks spent in a sample of the executions of each handler
+    std::array<std::uint64_t, HANDLER_COUNT> sampled_ticks{};
+    std::array<std::uint64_t, HANDLER_COUNT> samples{};
+    // Executions of the instruction at each address
+    std::array<std::uint64_t, System::MEMORY_SIZE> address_executions{};
+
+    [[nodiscard]] static std::string_view handler_name(std::uint8_t index);
+
+    [[nodiscard]] std::uint64_t total_executions() const;
+
+    /** @brief Estimated ticks spent in a handler, scaling its sampled ticks to all executions. */
+    [[nodiscard]] double estimated_ticks(std::uint8_t index) const;
+
+    /** @brief The most executed addresses, most executed first. */
+    [[nodiscard]] std::vector<Hotspot> hotspots(std::size_t count) const;
+
+    void merge(InstrumentationStats const& other);
+
+    /** @brief Write a human readable report of handlers by execution count, and hotspots. */
+    void report(std::ostream& out, std::size_t hotspot_count = 16) const;
+};
+
+/**
+ * @brief Collects execution statistics. Every execution is counted, while only one in
+ * SAMPLE_INTERVAL is timed, keeping the cost of reading the timestamp counter off most
+ * instructions.
+ */
+class Instrumentation {
+public:
+    static constexpr std::uint32_t SAMPLE_INTERVAL{64};
+
+private:
+    InstrumentationStats stats;
+    std::uint32_t sample_countdown{SAMPLE_INTERVAL};
+
+public:
+    /** @brief Read the timestamp counter, or a monotonic clock in nanoseconds on other hosts. */
+    [[nodiscard]] static std::uint64_t timestamp() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void count(std::uint8_t const index, std::uint16_t const address) noexcept {
+        ++stats.executions[index];
+        ++stats.address_executions[address % System::MEMORY_SIZE];
+    }
+
+    /** @brief Whether the next execution should be timed. */
+    [[nodiscard]] bool sample() noexcept {
+        if (--sample_countdown != 0) {
+            return false;
+        }
+        sample_countdown = SAMPLE_INTERVAL;
+        return true;
+    }
+
+    void time(std::uint8_t const index, std::uint64_t const ticks) noexcept {
+        stats.sampled_ticks[index] += ticks;
+        ++stats.samples[index];
+    }
+
+    /** @brief Statistics collected so far. */
+    [[nodiscard]] InstrumentationStats const& snapshot() const noexcept { return stats; }
+
+    void reset() noexcept { stats = {}; }
+};
+} // namespace Chip8
+#endif // CHIP8_INSTRUMENTATION_H
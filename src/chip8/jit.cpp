@@ -0,0 +1,245 @@
+#include "jit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+#if CHIP8_JIT_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "block_cache.h"
+#include "system.h"
+
+namespace Chip8 {
+#if CHIP8_JIT_SUPPORTED
+namespace {
+/** @brief Execute a decoded instruction, called from compiled code for non-inlined instructions. */
+void execute_decoded(System* const system, DecodedInstruction const* const decoded) noexcept {
+    (system->*decoded->execute)(decoded->instruction);
+}
+
+/**
+ * @brief Machine code emitter for the small subset of x86-64 used by compiled blocks. Throughout
+ * compiled code, rbx holds the System pointer, and all state is addressed as [rbx + disp32].
+ */
+class Emitter {
+private:
+    // ModRM byte selecting [rbx + disp32] with a zero reg field, for al or an opcode extension /0
+    static constexpr std::uint8_t MODRM_RBX_DISP32{0x83};
+
+    std::vector<std::uint8_t> code;
+
+    void bytes(std::initializer_list<std::uint8_t> const values) {
+        code.insert(code.end(), values);
+    }
+
+    template <typename T> void value(T const data) {
+        for (std::size_t idx{0}; idx < sizeof(T); ++idx) {
+            code.push_back(static_cast<std::uint8_t>(data >> (8 * idx)));
+        }
+    }
+
+    void rbx_operand(std::int32_t const disp) {
+        code.push_back(MODRM_RBX_DISP32);
+        value(static_cast<std::uint32_t>(disp));
+    }
+
+public:
+    [[nodiscard]] std::vector<std::uint8_t> const& data() const { return code; }
+
+    void prologue() {
+        bytes({0x53});             // push rbx (also aligns the stack for calls)
+        bytes({0x48, 0x89, 0xFB}); // mov rbx, rdi
+    }
+
+    void epilogue() {
+        bytes({0x5B}); // pop rbx
+        bytes({0xC3}); // ret
+    }
+
+    void store_byte(std::int32_t const disp, std::uint8_t const imm) {
+        bytes({0xC6}); // mov byte [rbx + disp], imm8
+        rbx_operand(disp);
+        value(imm);
+    }
+
+    void add_byte(std::int32_t const disp, std::uint8_t const imm) {
+        bytes({0x80}); // add byte [rbx + disp], imm8
+        rbx_operand(disp);
+        value(imm);
+    }
+
+    void store_word(std::int32_t const disp, std::uint16_t const imm) {
+        bytes({0x66, 0xC7}); // mov word [rbx + disp], imm16
+        rbx_operand(disp);
+        value(imm);
+    }
+
+    void load_al(std::int32_t const disp) {
+        bytes({0x8A}); // mov al, [rbx + disp]
+        rbx_operand(disp);
+    }
+
+    void load_eax_zero_extend(std::int32_t const disp) {
+        bytes({0x0F, 0xB6}); // movzx eax, byte [rbx + disp]
+        rbx_operand(disp);
+    }
+
+    void store_al(std::int32_t const disp) {
+        bytes({0x88}); // mov [rbx + disp], al
+        rbx_operand(disp);
+    }
+
+    void or_al(std::int32_t const disp) {
+        bytes({0x08}); // or [rbx + disp], al
+        rbx_operand(disp);
+    }
+
+    void and_al(std::int32_t const disp) {
+        bytes({0x20}); // and [rbx + disp], al
+        rbx_operand(disp);
+    }
+
+    void xor_al(std::int32_t const disp) {
+        bytes({0x30}); // xor [rbx + disp], al
+        rbx_operand(disp);
+    }
+
+    void add_ax_word(std::int32_t const disp) {
+        bytes({0x66, 0x01}); // add word [rbx + disp], ax
+        rbx_operand(disp);
+    }
+
+    void call_decoded(DecodedInstruction const* const decoded) {
+        bytes({0x48, 0x89, 0xDF}); // mov rdi, rbx
+        bytes({0x48, 0xBE});       // movabs rsi, decoded
+        value(reinterpret_cast<std::uintptr_t>(decoded));
+        bytes({0x48, 0xB8}); // movabs rax, execute_decoded
+        value(reinterpret_cast<std::uintptr_t>(&execute_decoded));
+        bytes({0xFF, 0xD0}); // call rax
+    }
+};
+} // namespace
+
+Jit::Jit(System const& system) {
+    auto const offset_of{[&system](void const* const field) {
+        return static_cast<std::int32_t>(static_cast<std::uint8_t const*>(field) -
+                                         reinterpret_cast<std::uint8_t const*>(&system));
+    }};
+
+    registers_offset = offset_of(system.registers.data());
+    program_counter_offset = offset_of(&system.program_counter);
+    index_register_offset = offset_of(&system.index_register);
+
+    void* const mapping{
+        mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error{"Error: failed to map executable memory for the JIT"};
+    }
+
+    arena = static_cast<std::uint8_t*>(mapping);
+}
+
+Jit::~Jit() { munmap(arena, ARENA_SIZE); }
+
+NativeBlock Jit::compile(Block const& block, std::uint16_t const address) {
+    std::int32_t const flag_offset{registers_offset + System::FLAG_REGISTER_IDX};
+
+    Emitter emitter{};
+    emitter.prologue();
+
+    // Whether the program counter in memory is up to date, only needed by called functions
+    bool program_counter_stored{false};
+
+    for (std::size_t idx{0}; idx < block.instructions.size(); ++idx) {
+        DecodedInstruction const& decoded{block.instructions[idx]};
+        Instruction const instruction{decoded.instruction};
+
+        std::int32_t const x_offset{registers_offset + instruction.x()};
+        std::int32_t const y_offset{registers_offset + instruction.y()};
+
+        program_counter_stored = false;
+
+        if (decoded.execute == &System::mov_vx_nn) {
+            emitter.store_byte(x_offset, instruction.nn());
+        } else if (decoded.execute == &System::add_vx_nn) {
+            emitter.add_byte(x_offset, instruction.nn());
+        } else if (decoded.execute == &System::mov_vx_vy) {
+            emitter.load_al(y_offset);
+            emitter.store_al(x_offset);
+        } else if (decoded.execute == &System::or_vx_vy) {
+            emitter.load_al(y_offset);
+            emitter.or_al(x_offset);
+            emitter.store_byte(flag_offset, 0);
+        } else if (decoded.execute == &System::and_vx_vy) {
+            emitter.load_al(y_offset);
+            emitter.and_al(x_offset);
+            emitter.store_byte(flag_offset, 0);
+        } else if (decoded.execute == &System::xor_vx_vy) {
+            emitter.load_al(y_offset);
+            emitter.xor_al(x_offset);
+            emitter.store_byte(flag_offset, 0);
+        } else if (decoded.execute == &System::mov_i_nnn) {
+            emitter.store_word(index_register_offset, instruction.nnn());
+        } else if (decoded.execute == &System::add_i_vx) {
+            emitter.load_eax_zero_extend(x_offset);
+            emitter.add_ax_word(index_register_offset);
+        } else {
+            // Functions expect the program counter to already point past their instruction
+            emitter.store_word(program_counter_offset,
+                               static_cast<std::uint16_t>(address + (2 * (idx + 1))));
+            emitter.call_decoded(&decoded);
+            program_counter_stored = true;
+        }
+    }
+
+    // If the block did not end by calling a function, which may have branched, step past it
+    if (!program_counter_stored) {
+        emitter.store_word(program_counter_offset,
+                           static_cast<std::uint16_t>(address + (2 * block.instructions.size())));
+    }
+
+    emitter.epilogue();
+
+    std::vector<std::uint8_t> const& code{emitter.data()};
+    if (used + code.size() > ARENA_SIZE) {
+        return nullptr;
+    }
+
+    // Keep the arena writable or executable, never both, flipping only the pages written to. The
+    // arena is page aligned, so those are the pages spanning the offsets written
+    auto const page_size{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    std::size_t const first{used - (used % page_size)};
+    std::size_t const last{used + code.size()};
+    std::size_t const length{((last - first + page_size - 1) / page_size) * page_size};
+
+    if (mprotect(arena + first, length, PROT_READ | PROT_WRITE) != 0) {
+        throw std::runtime_error{"Error: failed to make JIT memory writable"};
+    }
+    std::memcpy(arena + used, code.data(), code.size());
+    // Refused under some security policies, in which case the code must never be called
+    if (mprotect(arena + first, length, PROT_READ | PROT_EXEC) != 0) {
+        throw std::runtime_error{"Error: failed to make JIT memory executable"};
+    }
+
+    auto const native{reinterpret_cast<NativeBlock>(arena + used)};
+    used += code.size();
+
+    return native;
+}
+#else
+Jit::Jit(System const& system) {
+    throw std::runtime_error{"Error: the JIT is not supported on this platform"};
+}
+
+Jit::~Jit() = default;
+
+NativeBlock Jit::compile(Block const& block, std::uint16_t const address) { return nullptr; }
+#endif
+} // namespace Chip8
@@ -0,0 +1,59 @@
+#ifndef CHIP8_JIT_H
+#define CHIP8_JIT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "block_cache.h"
+#include "system.h"
+
+#if defined(__x86_64__) && defined(__unix__)
+#define CHIP8_JIT_SUPPORTED 1
+#else
+#define CHIP8_JIT_SUPPORTED 0
+#endif
+
+namespace Chip8 {
+/**
+ * @brief Dynamic recompiler, translating decoded blocks into native x86-64 code. Register and
+ * ALU instructions are emitted inline, operating on the system state through a base pointer,
+ * while every other instruction calls back into its System function, so any instruction is
+ * supported. Compiled code is placed in an executable arena owned by the compiler.
+ */
+class Jit {
+private:
+    std::uint8_t* arena{nullptr};
+    std::size_t used{0};
+
+    // Offsets of the system state accessed by compiled code, relative to the System pointer
+    std::int32_t registers_offset;
+    std::int32_t program_counter_offset;
+    std::int32_t index_register_offset;
+
+public:
+    static constexpr std::size_t ARENA_SIZE{0x40000};
+
+    /** @brief Whether native code generation is supported on the host. */
+    static constexpr bool supported() { return CHIP8_JIT_SUPPORTED != 0; }
+
+    /**
+     * @brief Create a compiler, with the layout of the state taken from the given system. Throws
+     * if the host is not supported, or the executable arena cannot be mapped.
+     */
+    explicit Jit(System const& system);
+    ~Jit();
+
+    Jit(Jit const&) = delete;
+    Jit& operator=(Jit const&) = delete;
+
+    /**
+     * @brief Compile a block which starts at the given address. The block must outlive the
+     * compiled code. Returns nullptr when the arena is full, in which case it must be reset.
+     */
+    [[nodiscard]] NativeBlock compile(Block const& block, std::uint16_t address);
+
+    /** @brief Discard all compiled code. Any previously returned NativeBlock becomes invalid. */
+    void reset() noexcept { used = 0; }
+};
+} // namespace Chip8
+#endif // CHIP8_JIT_H
@@ -0,0 +1,35 @@
+#ifndef CHIP8_PARSE_H
+#define CHIP8_PARSE_H
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace Chip8 {
+/**
+ * @brief Parse the whole of a text as a number, returning nothing if any of it is not part of the
+ * number. Integers may be in any base, with an optional 0x prefix in base 16.
+ */
+template <typename T>
+std::optional<T> parse_number(std::string_view text, [[maybe_unused]] int const base = 10) {
+    T value{};
+    std::from_chars_result result{};
+
+    if constexpr (std::is_floating_point_v<T>) {
+        result = std::from_chars(text.data(), text.data() + text.size(), value);
+    } else {
+        if (base == 16 && (text.starts_with("0x") || text.starts_with("0X"))) {
+            text.remove_prefix(2);
+        }
+        result = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    }
+
+    if (result.ec != std::errc{} || result.ptr != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+} // namespace Chip8
+#endif // CHIP8_PARSE_H
@@ -0,0 +1,136 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "emulator.h"
+#include "input_log.h"
+#include "system.h"
+
+namespace Chip8 {
+Profiler::Profiler(std::uint32_t const interval) : interval{std::max<std::uint32_t>(interval, 1)} {
+    until_sample = next_gap();
+}
+
+std::uint64_t Profiler::next_gap() noexcept {
+    // Uniform between half and one and a half intervals, averaging one interval
+    return (interval / 2) + (jitter() % interval) + 1;
+}
+
+void Profiler::run(Emulator& emulator, std::uint64_t cycles, InputPlayer* const player) {
+    while (cycles > 0) {
+        std::uint64_t const step{std::min(cycles, until_sample)};
+
+        if (player != nullptr) {
+            player->run(emulator, step);
+        } else {
+            emulator.run(step);
+        }
+        cycles -= step;
+        advance(emulator.system, step);
+    }
+}
+
+void Profiler::advance(System const& system, std::uint64_t const executed) {
+    until_sample -= std::min(executed, until_sample);
+
+    if (until_sample == 0) {
+        sample(system);
+        until_sample = next_gap();
+    }
+}
+
+void Profiler::sample(System const& system) {
+    ++samples;
+    ++heat.at(system.program_counter % System::MEMORY_SIZE);
+
+    std::vector<std::uint16_t> frames(system.stack_depth);
+    for (std::size_t depth{0}; depth < frames.size(); ++depth) {
+        std::uint16_t const call_address{
+            static_cast<std::uint16_t>((system.stack[depth] - 2) % System::MEMORY_SIZE)};
+
+        // The entry address is the NNN of the 2NNN instruction which made the call
+        frames[depth] = static_cast<std::uint16_t>(
+            ((system.memory[call_address] << 8) |
+             system.memory[(call_address + 1) % System::MEMORY_SIZE]) &
+            0x0FFF);
+    }
+
+    ++stacks[frames];
+}
+
+void Profiler::merge(Profiler const& other) {
+    samples += other.samples;
+    for (std::size_t address{0}; address < heat.size(); ++address) {
+        heat[address] += other.heat[address];
+    }
+    for (auto const& [frames, count] : other.stacks) {
+        stacks[frames] += count;
+    }
+}
+
+void Profiler::write_folded(std::ostream& out) const {
+    for (auto const& [frames, count] : stacks) {
+        std::string line{"main"};
+        for (std::uint16_t const entry : frames) {
+            line += std::format(";sub_{:03X}", entry);
+        }
+        out << std::format("{} {}\n", line, count);
+    }
+}
+
+void Profiler::write_heat_map(std::ostream& out) const {
+    static constexpr std::string_view SHADES{" .:-=+*#%@"};
+    static constexpr std::size_t LINE_ADDRESSES{64};
+
+    std::uint64_t const hottest{std::max<std::uint64_t>(*std::ranges::max_element(heat), 1)};
+    double const scale{std::log(static_cast<double>(hottest) + 1)};
+
+    out << std::format("# {} samples, shaded '{}' from none to {} samples per address\n",
+                       samples, SHADES, hottest);
+
+    for (std::size_t line{0}; line < heat.size(); line += LINE_ADDRESSES) {
+        std::string shades{};
+        std::uint64_t line_samples{0};
+
+        for (std::size_t address{line}; address < line + LINE_ADDRESSES; ++address) {
+            std::uint64_t const count{heat[address]};
+            line_samples += count;
+
+            // Any sampled address gets at least the lightest visible shade
+            std::size_t shade{0};
+            if (count != 0) {
+                double const level{std::log(static_cast<double>(count) + 1) / scale};
+                auto const visible_shades{static_cast<double>(SHADES.size() - 2)};
+                shade = 1 + static_cast<std::size_t>(level * visible_shades);
+            }
+            shades += SHADES[std::min(shade, SHADES.size() - 1)];
+        }
+
+        out << std::format("0x{:03X} |{}| {}\n", line, shades, line_samples);
+    }
+}
+
+void Profiler::write_files(std::string_view const prefix) const {
+    std::string const folded_path{std::format("{}.folded", prefix)};
+    std::string const heat_path{std::format("{}.heat", prefix)};
+
+    std::ofstream folded{folded_path};
+    write_folded(folded);
+    std::ofstream heat_map{heat_path};
+    write_heat_map(heat_map);
+
+    if (!folded || !heat_map) {
+        throw std::runtime_error{"Error: could not write profile to " + std::string{prefix}};
+    }
+}
+} // namespace Chip8
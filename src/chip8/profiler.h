@@ -0,0 +1,79 @@
+#ifndef CHIP8_PROFILER_H
+#define CHIP8_PROFILER_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "emulator.h"
+#include "input_log.h"
+#include "random.h"
+#include "system.h"
+
+namespace Chip8 {
+/**
+ * @brief Sampling profiler for CHIP-8 programs. Periodically samples the program counter and the
+ * CHIP-8 call stack, building a heat map of executed addresses and a count of each distinct call
+ * stack, which can be written as folded stacks for flame graph tools.
+ *
+ * Subroutines are named by their entry address, recovered from the call instruction before each
+ * return address on the stack.
+ */
+class Profiler {
+public:
+    static constexpr std::uint32_t DEFAULT_INTERVAL{97};
+
+private:
+    std::uint32_t interval;
+    // Randomises the gap between samples, so loops of a fixed length are not aliased
+    Pcg32 jitter{};
+    std::uint64_t until_sample{0};
+
+    std::uint64_t samples{0};
+    std::array<std::uint64_t, System::MEMORY_SIZE> heat{};
+    // Sample counts of each call stack, as subroutine entry addresses, outermost first
+    std::map<std::vector<std::uint16_t>, std::uint64_t> stacks;
+
+    [[nodiscard]] std::uint64_t next_gap() noexcept;
+
+public:
+    explicit Profiler(std::uint32_t interval = DEFAULT_INTERVAL);
+
+    /**
+     * @brief Execute exactly the given number of instructions, sampling on average once every
+     * interval instructions. With a player, execution goes through it, so that recorded input is
+     * replayed while profiling.
+     */
+    void run(Emulator& emulator, std::uint64_t cycles, InputPlayer* player = nullptr);
+
+    /** @brief Account for executed instructions, sampling the system if a sample is due. */
+    void advance(System const& system, std::uint64_t executed);
+
+    /** @brief Record a single sample of the current state of a system. */
+    void sample(System const& system);
+
+    void merge(Profiler const& other);
+
+    [[nodiscard]] std::uint64_t sample_count() const noexcept { return samples; }
+
+    [[nodiscard]] std::array<std::uint64_t, System::MEMORY_SIZE> const& heat_map() const noexcept {
+        return heat;
+    }
+
+    /** @brief Write one line per distinct call stack, as "main;sub_2A0;sub_31C <samples>". */
+    void write_folded(std::ostream& out) const;
+
+    /**
+     * @brief Write the heat map of memory as a grid of 64 addresses per line, each shaded by its
+     * share of samples on a logarithmic scale, followed by the samples in that line.
+     */
+    void write_heat_map(std::ostream& out) const;
+
+    /** @brief Write the folded stacks to prefix.folded and the heat map to prefix.heat. */
+    void write_files(std::string_view prefix) const;
+};
+} // namespace Chip8
+#endif // CHIP8_PROFILER_H
@@ -0,0 +1,63 @@
+#ifndef CHIP8_RANDOM_H
+#define CHIP8_RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+#ifdef CHIP8_USE_MT19937
+#include <random>
+#endif
+
+namespace Chip8 {
+/**
+ * @brief PCG32 (XSH RR variant) random number generator. Holds 8 bytes of state and is seeded
+ * with a few arithmetic operations, so constructing one is effectively free, unlike std::mt19937
+ * seeded from std::random_device. Satisfies UniformRandomBitGenerator.
+ */
+class Pcg32 {
+private:
+    static constexpr std::uint64_t MULTIPLIER{6364136223846793005ULL};
+    static constexpr std::uint64_t INCREMENT{1442695040888963407ULL};
+
+    std::uint64_t state{0};
+
+public:
+    using result_type = std::uint32_t;
+
+    static constexpr std::uint64_t DEFAULT_SEED{0x853C49E6748FEA9BULL};
+
+    constexpr explicit Pcg32(std::uint64_t const value = DEFAULT_SEED) noexcept { seed(value); }
+
+    constexpr void seed(std::uint64_t const value) noexcept {
+        state = 0;
+        (*this)();
+        state += value;
+        (*this)();
+    }
+
+    constexpr result_type operator()() noexcept {
+        std::uint64_t const previous{state};
+        state = (previous * MULTIPLIER) + INCREMENT;
+
+        auto const xorshifted{static_cast<std::uint32_t>(((previous >> 18U) ^ previous) >> 27U)};
+        auto const rotation{static_cast<std::uint32_t>(previous >> 59U)};
+        return (xorshifted >> rotation) | (xorshifted << ((32U - rotation) & 31U));
+    }
+
+    static constexpr result_type min() noexcept { return 0; }
+    static constexpr result_type max() noexcept { return std::numeric_limits<result_type>::max(); }
+
+    constexpr bool operator==(Pcg32 const&) const noexcept = default;
+};
+
+/**
+ * @brief Generator behind rnd_vx_nn. PCG32 by default, or std::mt19937 when built with the
+ * CHIP8_USE_MT19937 option. Either way, it starts from a fixed seed until seeded explicitly.
+ */
+#ifdef CHIP8_USE_MT19937
+using Random = std::mt19937;
+#else
+using Random = Pcg32;
+#endif
+} // namespace Chip8
+#endif // CHIP8_RANDOM_H
@@ -0,0 +1,139 @@
+#include "rewind_buffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "save_state.h"
+
+namespace Chip8 {
+namespace {
+static_assert(sizeof(SaveState) <= 0xFFFF, "Run lengths are encoded in 16 bits");
+
+// Zero bytes needed to end a literal run, as shorter gaps are cheaper to store as literals
+constexpr std::size_t MIN_ZERO_RUN{4};
+
+void put_length(std::vector<std::uint8_t>& out, std::size_t const length) {
+    out.push_back(static_cast<std::uint8_t>(length & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(length >> 8));
+}
+
+std::size_t get_length(std::span<std::uint8_t const> const in, std::size_t const position) {
+    return in[position] | (static_cast<std::size_t>(in[position + 1]) << 8);
+}
+
+/**
+ * @brief Append the delta between two states: the XOR of their bytes, as alternating runs of a
+ * zero byte count, then a literal byte count and the literal bytes.
+ */
+void encode(SaveState const& base, SaveState const& state, std::vector<std::uint8_t>& out) {
+    auto const* const old_bytes{reinterpret_cast<std::uint8_t const*>(&base)};
+    auto const* const new_bytes{reinterpret_cast<std::uint8_t const*>(&state)};
+
+    auto const is_zero_run{[&](std::size_t const position) {
+        std::size_t const end{std::min(position + MIN_ZERO_RUN, sizeof(SaveState))};
+        for (std::size_t i{position}; i < end; ++i) {
+            if (old_bytes[i] != new_bytes[i]) {
+                return false;
+            }
+        }
+        return true;
+    }};
+
+    std::size_t position{0};
+    while (position < sizeof(SaveState)) {
+        std::size_t const zeros_start{position};
+        while (position < sizeof(SaveState) && old_bytes[position] == new_bytes[position]) {
+            ++position;
+        }
+        std::size_t const literals_start{position};
+        while (position < sizeof(SaveState) && !is_zero_run(position)) {
+            ++position;
+        }
+
+        put_length(out, literals_start - zeros_start);
+        put_length(out, position - literals_start);
+        for (std::size_t i{literals_start}; i < position; ++i) {
+            out.push_back(old_bytes[i] ^ new_bytes[i]);
+        }
+    }
+}
+
+void decode(SaveState const& base, std::span<std::uint8_t const> const delta, SaveState& state) {
+    state = base;
+    auto* const bytes{reinterpret_cast<std::uint8_t*>(&state)};
+
+    std::size_t position{0};
+    std::size_t read{0};
+    while (read < delta.size()) {
+        position += get_length(delta, read);
+        std::size_t const literals{get_length(delta, read + 2)};
+        read += 4;
+
+        for (std::size_t i{0}; i < literals; ++i) {
+            bytes[position++] ^= delta[read++];
+        }
+    }
+}
+} // namespace
+
+RewindBuffer::RewindBuffer(std::size_t const budget, std::uint16_t const keyframe_interval)
+    : budget{budget}, keyframe_interval{std::max<std::uint16_t>(keyframe_interval, 1)} {}
+
+void RewindBuffer::push(SaveState const& state) {
+    if (groups.empty() || groups.back().offsets.size() + 1 >= keyframe_interval) {
+        groups.push_back(Group{.keyframe = state, .deltas = {}, .offsets = {}});
+        used_bytes += groups.back().bytes();
+    } else {
+        Group& group{groups.back()};
+        std::size_t const before{group.bytes()};
+
+        group.offsets.push_back(static_cast<std::uint32_t>(group.deltas.size()));
+        encode(group.keyframe, state, group.deltas);
+
+        used_bytes += group.bytes() - before;
+    }
+    ++count;
+
+    // Drop the oldest groups, always keeping the newest so that recent history survives
+    while (used_bytes > budget && groups.size() > 1) {
+        used_bytes -= groups.front().bytes();
+        count -= groups.front().offsets.size() + 1;
+        groups.pop_front();
+    }
+}
+
+bool RewindBuffer::pop(SaveState& state) {
+    if (groups.empty()) {
+        return false;
+    }
+
+    Group& group{groups.back()};
+    if (group.offsets.empty()) {
+        state = group.keyframe;
+        used_bytes -= group.bytes();
+        groups.pop_back();
+    } else {
+        std::size_t const before{group.bytes()};
+        std::size_t const start{group.offsets.back()};
+
+        decode(group.keyframe, std::span{group.deltas}.subspan(start), state);
+        group.deltas.resize(start);
+        group.offsets.pop_back();
+
+        used_bytes -= before - group.bytes();
+    }
+    --count;
+
+    return true;
+}
+
+void RewindBuffer::clear() noexcept {
+    groups.clear();
+    used_bytes = 0;
+    count = 0;
+}
+} // namespace Chip8
@@ -0,0 +1,61 @@
+#ifndef CHIP8_REWIND_BUFFER_H
+#define CHIP8_REWIND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "save_state.h"
+
+namespace Chip8 {
+/**
+ * @brief History of save states, one per frame, for stepping backwards through execution.
+ *
+ * States are stored in groups, each starting with a full keyframe followed by deltas against it.
+ * A delta is the state XORed with its keyframe, run length encoded, so the mostly unchanged memory
+ * and display of consecutive frames costs almost nothing. Whole groups of the oldest history are
+ * dropped to keep memory use within a budget.
+ */
+class RewindBuffer {
+public:
+    static constexpr std::uint16_t DEFAULT_KEYFRAME_INTERVAL{60};
+
+private:
+    struct Group {
+        SaveState keyframe;
+        // Encoded deltas, back to back, where delta N starts at offsets[N]
+        std::vector<std::uint8_t> deltas;
+        std::vector<std::uint32_t> offsets;
+
+        [[nodiscard]] std::size_t bytes() const noexcept {
+            return sizeof(SaveState) + deltas.size() + (offsets.size() * sizeof(std::uint32_t));
+        }
+    };
+
+    std::deque<Group> groups;
+    std::size_t budget;
+    std::uint16_t keyframe_interval;
+    std::size_t used_bytes{0};
+    std::size_t count{0};
+
+public:
+    explicit RewindBuffer(std::size_t budget,
+                          std::uint16_t keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+
+    /** @brief Record the newest state, dropping the oldest history if over budget. */
+    void push(SaveState const& state);
+
+    /** @brief Remove the newest state into state. Returns false if there is no history. */
+    bool pop(SaveState& state);
+
+    void clear() noexcept;
+
+    /** @brief Number of states held. */
+    [[nodiscard]] std::size_t size() const noexcept { return count; }
+
+    /** @brief Bytes used by the held states, which is kept within budget. */
+    [[nodiscard]] std::size_t memory_usage() const noexcept { return used_bytes; }
+};
+} // namespace Chip8
+#endif // CHIP8_REWIND_BUFFER_H
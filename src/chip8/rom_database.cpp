@@ -0,0 +1,82 @@
+#include "rom_database.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "config.h"
+#include "parse.h"
+
+namespace Chip8 {
+namespace {
+/** @brief Parse an RRGGBB colour as opaque ARGB8888. Only the six hex digits are accepted. */
+std::optional<std::uint32_t> parse_colour(std::string_view const text) {
+    if (text.size() != 6 ||
+        !std::ranges::all_of(text, [](unsigned char const c) { return std::isxdigit(c) != 0; })) {
+        return std::nullopt;
+    }
+    return 0xFF000000 | *parse_number<std::uint32_t>(text, 16);
+}
+} // namespace
+
+RomDatabase RomDatabase::read(std::filesystem::path const& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error{"Error: failed to open ROM database: " + path.string()};
+    }
+
+    RomDatabase database{};
+    std::string line{};
+    for (std::size_t number{1}; std::getline(file, line); ++number) {
+        std::istringstream columns{line};
+        std::string hash{};
+        std::string quirks{};
+        std::string ipf{};
+        std::string foreground{};
+        std::string background{};
+
+        if (!(columns >> hash) || hash.starts_with('#')) {
+            continue;
+        }
+        columns >> quirks >> ipf >> foreground >> background;
+
+        RomProfile profile{};
+        std::getline(columns >> std::ws, profile.name);
+
+        std::optional<std::uint64_t> const key{parse_number<std::uint64_t>(hash, 16)};
+        std::optional<Config> const config{Config::named(quirks)};
+        std::optional<std::uint16_t> const tick_rate{parse_number<std::uint16_t>(ipf, 10)};
+        std::optional<std::uint32_t> const on{parse_colour(foreground)};
+        std::optional<std::uint32_t> const off{parse_colour(background)};
+        if (!key || !config || !tick_rate || *tick_rate == 0 || !on || !off) {
+            throw std::runtime_error{"Error: malformed ROM database entry at " + path.string() +
+                                     ":" + std::to_string(number)};
+        }
+
+        profile.config = *config;
+        profile.config.tick_rate = *tick_rate;
+        profile.foreground = *on;
+        profile.background = *off;
+        database.add(*key, std::move(profile));
+    }
+
+    return database;
+}
+
+void RomDatabase::add(std::uint64_t const hash, RomProfile profile) {
+    profiles.insert_or_assign(hash, std::move(profile));
+}
+
+RomProfile const* RomDatabase::find(std::uint64_t const hash) const noexcept {
+    auto const found{profiles.find(hash)};
+    return found == profiles.end() ? nullptr : &found->second;
+}
+} // namespace Chip8
@@ -0,0 +1,52 @@
+#ifndef CHIP8_ROM_DATABASE_H
+#define CHIP8_ROM_DATABASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include "config.h"
+
+namespace Chip8 {
+/** @brief How a particular ROM is meant to be run and shown. */
+struct RomProfile {
+    std::string name;
+    // Quirks, display limits and instructions per frame
+    Config config{};
+    // Colours of on and off pixels, as ARGB8888
+    std::uint32_t foreground{0xFFFFFFFF};
+    std::uint32_t background{0xFF000000};
+};
+
+/**
+ * @brief Profiles of known ROMs, keyed by the hash of their contents, so a ROM is recognised
+ * whatever its file is called. The database is a text file with a line per ROM of whitespace
+ * separated columns, where the colours are RGB hex and the name is the rest of the line:
+ *
+ *     # hash            quirks  ipf  foreground  background  name
+ *     0123456789ABCDEF  schip   30   FFCC00      996600      Some game
+ *
+ * Quirks are named as on the command line, chip8, schip or xochip.
+ */
+class RomDatabase {
+private:
+    std::unordered_map<std::uint64_t, RomProfile> profiles;
+
+public:
+    RomDatabase() = default;
+
+    /** @brief Read a database, throwing if it cannot be read or a line is malformed. */
+    static RomDatabase read(std::filesystem::path const& path);
+
+    /** @brief Add a profile, replacing any existing profile for the same ROM. */
+    void add(std::uint64_t hash, RomProfile profile);
+
+    /** @brief Find the profile of a ROM by its hash, or nullptr if it is not known. */
+    [[nodiscard]] RomProfile const* find(std::uint64_t hash) const noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept { return profiles.size(); }
+};
+} // namespace Chip8
+#endif // CHIP8_ROM_DATABASE_H
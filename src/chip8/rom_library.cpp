@@ -0,0 +1,224 @@
+#include "rom_library.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "parse.h"
+#include "system.h"
+
+namespace Chip8 {
+namespace {
+void check_size(std::filesystem::path const& path, std::size_t const size) {
+    if (size > System::MAX_ROM_SIZE) {
+        throw std::runtime_error{std::format(
+            "Error: ROM is {} bytes, but at most {} fit in memory: {}", size, System::MAX_ROM_SIZE,
+            path.string())};
+    }
+}
+} // namespace
+
+MappedRom::MappedRom(std::filesystem::path const& path) {
+#ifdef __unix__
+    int const file{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file < 0) {
+        throw std::runtime_error{"Error: file not found at path: " + path.string()};
+    }
+
+    struct stat status{};
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error{"Error: could not read ROM " + path.string()};
+    }
+    size = static_cast<std::size_t>(status.st_size);
+
+    try {
+        check_size(path, size);
+    } catch (...) {
+        close(file);
+        throw;
+    }
+
+    // Empty files cannot be mapped, but are valid, if useless, ROMs
+    if (size != 0) {
+        void* const mapped{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0)};
+        if (mapped == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error{"Error: could not map ROM " + path.string()};
+        }
+        data = static_cast<std::uint8_t const*>(mapped);
+    }
+    close(file);
+#else
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        throw std::runtime_error{"Error: file not found at path: " + path.string()};
+    }
+    contents.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    check_size(path, contents.size());
+
+    data = contents.data();
+    size = contents.size();
+#endif
+}
+
+MappedRom::~MappedRom() {
+#ifdef __unix__
+    if (data != nullptr) {
+        munmap(const_cast<std::uint8_t*>(data), size);
+    }
+#endif
+}
+
+std::uint64_t rom_hash(std::span<std::uint8_t const> const rom) noexcept {
+    constexpr std::uint64_t FNV_OFFSET_BASIS{0xCBF29CE484222325};
+    constexpr std::uint64_t FNV_PRIME{0x100000001B3};
+
+    std::uint64_t hash{FNV_OFFSET_BASIS};
+    for (std::uint8_t const byte : rom) {
+        hash ^= byte;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+RomLibrary::RomLibrary(std::filesystem::path index_path) : index_path{std::move(index_path)} {
+    if (this->index_path.empty()) {
+        return;
+    }
+
+    std::ifstream file{this->index_path};
+    if (!file) {
+        // A new library, written on first save
+        return;
+    }
+
+    // Lines which do not parse are dropped, so those ROMs are hashed again on their next scan
+    for (std::string line{}; std::getline(file, line);) {
+        std::array<std::string_view, 4> fields{};
+        std::string_view rest{line};
+        for (std::size_t idx{0}; idx < fields.size() - 1; ++idx) {
+            std::size_t const tab{std::min(rest.find('\t'), rest.size())};
+            fields[idx] = rest.substr(0, tab);
+            rest.remove_prefix(std::min(tab + 1, rest.size()));
+        }
+        fields.back() = rest;
+
+        std::optional<std::uint64_t> const hash{parse_number<std::uint64_t>(fields[0], 16)};
+        std::optional<std::uint32_t> const size{parse_number<std::uint32_t>(fields[1], 10)};
+        std::optional<std::int64_t> const modified{parse_number<std::int64_t>(fields[2], 10)};
+        if (!hash || !size || !modified || fields[3].empty()) {
+            changed = true;
+            continue;
+        }
+
+        std::string path{fields[3]};
+        roms.insert_or_assign(path, RomInfo{.hash = *hash,
+                                            .size = *size,
+                                            .modified = *modified,
+                                            .path = path});
+    }
+}
+
+RomInfo const& RomLibrary::scan(std::filesystem::path const& path) {
+    // Keyed by absolute path, so the index is valid from any working directory
+    std::string const key{std::filesystem::absolute(path).lexically_normal().string()};
+
+    std::error_code error{};
+    std::uintmax_t const size{std::filesystem::file_size(path, error)};
+    std::int64_t const modified{
+        error ? 0 : std::filesystem::last_write_time(path, error).time_since_epoch().count()};
+    if (error) {
+        throw std::runtime_error{"Error: file not found at path: " + path.string()};
+    }
+
+    auto const found{roms.find(key)};
+    if (found != roms.end() && found->second.size == size && found->second.modified == modified) {
+        return found->second;
+    }
+
+    MappedRom const rom{path};
+    changed = true;
+    return roms.insert_or_assign(key, RomInfo{.hash = rom_hash(rom.bytes()),
+                                              .size = static_cast<std::uint32_t>(size),
+                                              .modified = modified,
+                                              .path = key})
+        .first->second;
+}
+
+std::vector<RomInfo> RomLibrary::scan_directory(std::filesystem::path const& directory) {
+    std::vector<std::filesystem::path> paths{};
+    for (auto const& entry : std::filesystem::recursive_directory_iterator{directory}) {
+        std::string extension{entry.path().extension().string()};
+        std::ranges::transform(extension, extension.begin(),
+                               [](unsigned char const c) { return std::tolower(c); });
+
+        if (entry.is_regular_file() &&
+            std::ranges::find(EXTENSIONS, extension) != EXTENSIONS.end()) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+
+    std::vector<RomInfo> scanned{};
+    scanned.reserve(paths.size());
+    for (std::filesystem::path const& path : paths) {
+        try {
+            scanned.push_back(scan(path));
+        } catch (std::runtime_error const& error) {
+            std::println(stderr, "Warning: skipping ROM: {}", error.what());
+        }
+    }
+    return scanned;
+}
+
+std::optional<RomInfo> RomLibrary::find(std::uint64_t const hash) const {
+    auto const found{
+        std::ranges::find(roms, hash, [](auto const& rom) { return rom.second.hash; })};
+    if (found == roms.end()) {
+        return std::nullopt;
+    }
+    return found->second;
+}
+
+void RomLibrary::save() {
+    if (index_path.empty() || !changed) {
+        return;
+    }
+
+    // Write alongside and rename over, so an interrupted save never leaves a partial index
+    std::filesystem::path temporary{index_path};
+    temporary += ".tmp";
+    {
+        std::ofstream file{temporary, std::ios::trunc};
+        for (auto const& [path, rom] : roms) {
+            file << std::format("{:016X}\t{}\t{}\t{}\n", rom.hash, rom.size, rom.modified, path);
+        }
+        if (!file) {
+            throw std::runtime_error{"Error: could not write ROM index " + temporary.string()};
+        }
+    }
+    std::filesystem::rename(temporary, index_path);
+
+    changed = false;
+}
+} // namespace Chip8
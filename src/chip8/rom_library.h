@@ -0,0 +1,94 @@
+#ifndef CHIP8_ROM_LIBRARY_H
+#define CHIP8_ROM_LIBRARY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Chip8 {
+/**
+ * @brief A ROM file mapped read only into memory, so loading it into an emulator is the only
+ * copy made. Throws on construction if the file cannot be read, or is too large to fit in memory
+ * above the program start.
+ */
+class MappedRom {
+private:
+    std::uint8_t const* data{nullptr};
+    std::size_t size{0};
+#ifndef __unix__
+    std::vector<std::uint8_t> contents;
+#endif
+
+public:
+    explicit MappedRom(std::filesystem::path const& path);
+    ~MappedRom();
+
+    MappedRom(MappedRom const&) = delete;
+    MappedRom& operator=(MappedRom const&) = delete;
+
+    [[nodiscard]] std::span<std::uint8_t const> bytes() const noexcept { return {data, size}; }
+};
+
+/** @brief 64-bit FNV-1a hash of a ROM's contents, identifying it regardless of its path. */
+[[nodiscard]] std::uint64_t rom_hash(std::span<std::uint8_t const> rom) noexcept;
+
+/** @brief What is known of a ROM file, as of when it last changed. */
+struct RomInfo {
+    std::uint64_t hash{0};
+    std::uint32_t size{0};
+    // Modification time of the file when it was hashed, in the file clock's ticks
+    std::int64_t modified{0};
+    std::string path;
+};
+
+/**
+ * @brief Index of ROM files by path, recording the hash and size of each. Files are only read
+ * again when their size or modification time has changed since they were indexed, so scanning a
+ * large collection repeatedly is cheap. The index is kept on disk as lines of tab separated hash,
+ * size, modification time and path.
+ */
+class RomLibrary {
+private:
+    std::filesystem::path index_path;
+    std::map<std::string, RomInfo> roms;
+    bool changed{false};
+
+public:
+    /** @brief Extensions of files picked up when scanning a directory. */
+    static constexpr std::array<std::string_view, 4> EXTENSIONS{".ch8", ".c8", ".sc8", ".xo8"};
+
+    /**
+     * @brief Open a library, reading its index if it exists. Without an index path, the library
+     * is only kept in memory.
+     */
+    explicit RomLibrary(std::filesystem::path index_path = {});
+
+    /**
+     * @brief Get the details of a ROM file, hashing it unless unchanged since it was indexed.
+     * Throws if the file cannot be read or is too large.
+     */
+    RomInfo const& scan(std::filesystem::path const& path);
+
+    /**
+     * @brief Scan every ROM file under a directory, recursively, ordered by path. Files which
+     * cannot be read or are too large are skipped with a warning.
+     */
+    std::vector<RomInfo> scan_directory(std::filesystem::path const& directory);
+
+    /** @brief Find an indexed ROM with the given contents. */
+    [[nodiscard]] std::optional<RomInfo> find(std::uint64_t hash) const;
+
+    [[nodiscard]] std::size_t size() const noexcept { return roms.size(); }
+
+    /** @brief Write the index if anything has changed, replacing the previous index atomically. */
+    void save();
+};
+} // namespace Chip8
+#endif // CHIP8_ROM_LIBRARY_H
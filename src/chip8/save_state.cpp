@@ -0,0 +1,99 @@
+#include "save_state.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "system.h"
+
+namespace Chip8 {
+void SaveState::capture(System const& system) noexcept {
+    memory = system.memory;
+    program_counter = system.program_counter;
+    index_register = system.index_register;
+    stack = system.stack;
+    stack_depth = system.stack_depth;
+    delay_timer = system.delay_timer;
+    sound_timer = system.sound_timer;
+    registers = system.registers;
+    keys = system.keys;
+    key_released = system.key_released;
+    waiting = system.waiting;
+    display = system.display;
+    rng = system.rng;
+}
+
+void SaveState::restore(System& system) const noexcept {
+    system.memory = memory;
+    system.program_counter = program_counter;
+    system.index_register = index_register;
+    system.stack = stack;
+    system.stack_depth = stack_depth;
+    system.fault = Fault::NONE;
+    system.delay_timer = delay_timer;
+    system.sound_timer = sound_timer;
+    system.registers = registers;
+    system.keys = keys;
+    system.key_released = key_released;
+    system.waiting = waiting;
+    system.display = display;
+    system.display.mark_all_dirty();
+    system.rng = rng;
+}
+
+SaveState SaveState::from_bytes(std::span<std::byte const> const bytes) {
+    SaveState state{};
+    if (bytes.size() != sizeof(SaveState)) {
+        throw std::runtime_error{"Error: save state has the wrong size"};
+    }
+
+    std::memcpy(&state, bytes.data(), sizeof(SaveState));
+
+    if (state.magic != MAGIC) {
+        throw std::runtime_error{"Error: not a save state"};
+    }
+    if (state.version != VERSION || state.size != sizeof(SaveState)) {
+        throw std::runtime_error{"Error: save state is from an incompatible version"};
+    }
+
+    // Anything used as an index, divisor or bool must be checked before it reaches a System
+    bool const lores{state.display.width() == System::LORES_WIDTH &&
+                     state.display.height() == System::LORES_HEIGHT};
+    bool const hires{state.display.width() == System::HIRES_WIDTH &&
+                     state.display.height() == System::HIRES_HEIGHT};
+    auto const waiting{std::to_integer<std::uint8_t>(bytes[offsetof(SaveState, waiting)])};
+    if (state.stack_depth > System::STACK_DEPTH ||
+        state.program_counter >= System::MEMORY_SIZE || (!lores && !hires) || waiting > 1) {
+        throw std::runtime_error{"Error: save state is corrupt"};
+    }
+    return state;
+}
+
+SaveState SaveState::read(std::string_view const filename) {
+    std::string const path{filename};
+
+    std::ifstream file{path, std::ios::binary};
+    std::array<std::byte, sizeof(SaveState)> buffer{};
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()) ||
+        file.peek() != std::ifstream::traits_type::eof()) {
+        throw std::runtime_error{"Error: could not read save state " + path};
+    }
+    return from_bytes(buffer);
+}
+
+void SaveState::write(std::string_view const filename) const {
+    std::string const path{filename};
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    auto const data{bytes()};
+    if (!file.write(reinterpret_cast<char const*>(data.data()),
+                    static_cast<std::streamsize>(data.size()))) {
+        throw std::runtime_error{"Error: could not write save state " + path};
+    }
+}
+} // namespace Chip8
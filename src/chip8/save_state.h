@@ -0,0 +1,72 @@
+#ifndef CHIP8_SAVE_STATE_H
+#define CHIP8_SAVE_STATE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "framebuffer.h"
+#include "random.h"
+#include "system.h"
+
+namespace Chip8 {
+/**
+ * @brief Snapshot of the machine state of a System. It is trivially copyable, so taking or
+ * restoring a snapshot is a plain copy, and its bytes are its serialised form: a header
+ * identifying the format, followed by the state in the host's native layout. Padding is spelt out
+ * as reserved fields, so no byte of a state is left indeterminate.
+ */
+struct SaveState {
+    static constexpr std::array<char, 4> MAGIC{'C', '8', 'S', 'T'};
+    static constexpr std::uint16_t VERSION{2};
+
+    std::array<char, 4> magic{MAGIC};
+    std::uint16_t version{VERSION};
+    std::array<std::uint8_t, 2> reserved_header{};
+    // Size of the whole state, so that states written with a different layout are rejected
+    std::uint32_t size{sizeof(SaveState)};
+
+    std::array<std::uint8_t, System::MEMORY_SIZE> memory{};
+    std::uint16_t program_counter{0};
+    std::uint16_t index_register{0};
+    std::array<std::uint16_t, System::STACK_DEPTH> stack{}; // bottom of the stack first
+    std::uint8_t stack_depth{0};
+    std::uint8_t delay_timer{0};
+    std::uint8_t sound_timer{0};
+    std::array<std::uint8_t, System::REGISTER_COUNT> registers{};
+
+    std::array<std::uint8_t, System::NUM_KEYS> keys{};
+    std::uint8_t key_released{0xFF};
+    bool waiting{false};
+    std::array<std::uint8_t, 3> reserved_input{};
+
+    Framebuffer display{System::LORES_WIDTH, System::LORES_HEIGHT};
+    Random rng{};
+
+    /** @brief Capture the state of a system. */
+    void capture(System const& system) noexcept;
+
+    /** @brief Restore a system to this state. */
+    void restore(System& system) const noexcept;
+
+    [[nodiscard]] std::span<std::byte const> bytes() const noexcept {
+        return std::as_bytes(std::span{this, 1});
+    }
+
+    /** @brief Read a serialised state, throwing if it is not a state of this version and layout. */
+    [[nodiscard]] static SaveState from_bytes(std::span<std::byte const> bytes);
+
+    /** @brief Read a state from a file, throwing if it is not a valid state. */
+    [[nodiscard]] static SaveState read(std::string_view filename);
+
+    void write(std::string_view filename) const;
+};
+
+static_assert(std::is_trivially_copyable_v<SaveState>, "States are saved and loaded by copying");
+static_assert(std::has_unique_object_representations_v<SaveState>,
+              "States are compared and written byte for byte, so must have no padding");
+} // namespace Chip8
+#endif // CHIP8_SAVE_STATE_H
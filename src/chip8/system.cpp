@@ -2,99 +2,48 @@
 
 #include <print>
 
-#include "config.h"
 #include "fonts.h"
 #include "instruction.h"
 
 namespace Chip8 {
 void System::sc_down(Instruction const instruction) noexcept {
-    std::uint16_t const scroll_n{static_cast<std::uint16_t>(current_width * instruction.n())};
-    // Remove pixels scrolled down off the bottom of the screen
-    display.erase(display.end() - scroll_n, display.end());
-    // Insert blank pixels at start of vector, pushing the display down
-    display.insert(display.begin(), scroll_n, 0x0);
+    display.scroll_down(instruction.n());
 }
 
-void System::cls(Instruction const instruction) noexcept { std::ranges::fill(display, 0x0); }
+void System::cls(Instruction const instruction) noexcept { display.clear(); }
 
 void System::ret(Instruction const instruction) noexcept {
-    program_counter = stack.top();
-    stack.pop();
+    if (stack_depth == 0) [[unlikely]] {
+        fault = Fault::STACK_UNDERFLOW;
+        return;
+    }
+    program_counter = stack[--stack_depth];
 }
 
-void System::sc_right(Instruction const instruction) noexcept {
-    auto iter{display.begin()};
-    // Iterate row by row, performing scroll
-    while (iter != display.end()) {
-        // Remove pixels scrolled right off the row
-        display.erase(iter + current_width - 4, iter + current_width);
-        // Insert blank pixels at the start of the row, pushing the display right
-        display.insert(iter, 4, 0x0);
+void System::sc_right(Instruction const instruction) noexcept { display.scroll_right(4); }
 
-        if (std::distance(iter, display.end()) > current_width) {
-            std::advance(iter, current_width);
-        } else {
-            iter = display.end();
-        }
-    }
-}
-void System::sc_left(Instruction const instruction) noexcept {
-    auto iter{display.begin()};
-    // Iterate row by row, performing scroll
-    while (iter != display.end()) {
-        // Remove pixels scrolled left off the row
-        display.erase(iter, iter + 4);
-        // Insert blank pixels at the end of the row, pushing the display left
-        display.insert(iter + current_width - 4, 4, 0x0);
-
-        if (std::distance(iter, display.end()) > current_width) {
-            std::advance(iter, current_width);
-        } else {
-            iter = display.end();
-        }
-    }
-}
-void System::exit(Instruction const instruction) noexcept {
-    if (callback_function) {
-        callback_function(CallbackType::CHIP8_CALLBACK_EXIT);
-    } else {
-        std::println(
-            stderr,
-            "Warning: callback not set: SUPER-CHIP exit instruction needs to modify window state");
-    }
-}
-void System::lores(Instruction const instruction) noexcept {
-    if (callback_function) {
-        callback_function(CallbackType::CHIP8_CALLBACK_LORES);
-    } else {
-        std::println(
-            stderr,
-            "Warning: callback not set: SUPER-CHIP lores instruction needs to modify window state");
-    }
+void System::sc_left(Instruction const instruction) noexcept { display.scroll_left(4); }
+
+void System::exit(Instruction const instruction) noexcept { events.push(Event::EXIT); }
 
-    current_width = LORES_WIDTH;
-    current_height = LORES_HEIGHT;
-    display.resize(static_cast<size_t>(current_width * current_height));
+void System::lores(Instruction const instruction) noexcept {
+    display.resize(LORES_WIDTH, LORES_HEIGHT);
+    events.push(Event::LORES);
 }
 
 void System::hires(Instruction const instruction) noexcept {
-    if (callback_function) {
-        callback_function(CallbackType::CHIP8_CALLBACK_HIRES);
-    } else {
-        std::println(
-            stderr,
-            "Warning: callback not set: SUPER-CHIP hires instruction needs to modify window state");
-    }
-
-    current_width = HIRES_WIDTH;
-    current_height = HIRES_HEIGHT;
-    display.resize(static_cast<size_t>(current_width * current_height));
+    display.resize(HIRES_WIDTH, HIRES_HEIGHT);
+    events.push(Event::HIRES);
 }
 
 void System::jmp(Instruction const instruction) noexcept { program_counter = instruction.nnn(); }
 
 void System::call(Instruction const instruction) noexcept {
-    stack.push(program_counter);
+    if (stack_depth == STACK_DEPTH) [[unlikely]] {
+        fault = Fault::STACK_OVERFLOW;
+        return;
+    }
+    stack[stack_depth++] = program_counter;
     program_counter = instruction.nnn();
 }
 
@@ -168,8 +117,8 @@ void System::sub_vx_vy(Instruction const instruction) noexcept {
     // Set flag register to the borrow value
     registers.at(FLAG_REGISTER_IDX) = (register_x >= register_y) ? 1 : 0;
 }
-void System::shr_vx_vy(Instruction const instruction) noexcept {
-    if (!Config::shift_quirk) {
+template <bool ShiftQuirk> void System::shr_vx_vy(Instruction const instruction) noexcept {
+    if constexpr (!ShiftQuirk) {
         registers.at(instruction.x()) = registers.at(instruction.y());
     }
 
@@ -189,8 +138,8 @@ void System::rsb_vx_vy(Instruction const instruction) noexcept {
     registers.at(FLAG_REGISTER_IDX) = (register_y >= register_x) ? 1 : 0;
 }
 
-void System::shl_vx_vy(Instruction const instruction) noexcept {
-    if (!Config::shift_quirk) {
+template <bool ShiftQuirk> void System::shl_vx_vy(Instruction const instruction) noexcept {
+    if constexpr (!ShiftQuirk) {
         registers.at(instruction.x()) = registers.at(instruction.y());
     }
 
@@ -209,8 +158,8 @@ void System::sne_vx_vy(Instruction const instruction) noexcept {
 void System::mov_i_nnn(Instruction const instruction) noexcept {
     index_register = instruction.nnn();
 }
-void System::jmp_vx_nnn(Instruction const instruction) noexcept {
-    if (Config::jump_quirk) {
+template <bool JumpQuirk> void System::jmp_vx_nnn(Instruction const instruction) noexcept {
+    if constexpr (JumpQuirk) {
         program_counter = instruction.nnn() + registers.at(instruction.x());
     } else {
         program_counter = instruction.nnn() + registers.at(0x0);
@@ -218,44 +167,36 @@ void System::jmp_vx_nnn(Instruction const instruction) noexcept {
 }
 
 void System::rnd_vx_nn(Instruction const instruction) noexcept {
-    registers.at(instruction.x()) = dist(rng) & instruction.nn();
+    // The top bits are the best distributed for both generators
+    registers.at(instruction.x()) = static_cast<std::uint8_t>(rng() >> 24) & instruction.nn();
 }
 
 void System::drw(Instruction const instruction) noexcept {
     std::uint8_t const register_x{
-        static_cast<std::uint8_t>(registers.at(instruction.x()) % current_width)};
+        static_cast<std::uint8_t>(registers.at(instruction.x()) % display.width())};
     std::uint8_t const register_y{
-        static_cast<std::uint8_t>(registers.at(instruction.y()) % current_height)};
-
-    registers.at(FLAG_REGISTER_IDX) = 0;
+        static_cast<std::uint8_t>(registers.at(instruction.y()) % display.height())};
 
     bool const is_super_chip{instruction.n() == 0};
 
     std::uint8_t const n_col{static_cast<uint8_t>(is_super_chip ? 16 : 8)};
     std::uint8_t const n_row{static_cast<uint8_t>(is_super_chip ? 16 : instruction.n())};
 
-    for (std::uint8_t row = 0; row < n_row && register_y + row < current_height; row++) {
-        for (std::uint8_t col = 0; col < n_col && register_x + col < current_width; col++) {
-            std::uint8_t byte{0};
-            if (is_super_chip) {
-                byte = memory.at(index_register + (2 * row) + (col >= 8 ? 1 : 0));
-            } else {
-                byte = memory.at(index_register + row);
-            }
-
-            // Extract current pixel from byte using bit shift and binary and
-            std::uint8_t const pixel{
-                static_cast<std::uint8_t>(byte & (0b10000000 >> (col >= 8 ? (col & 0x7) : col)))};
-            if (pixel != 0) {
-                std::uint16_t const idx{static_cast<std::uint16_t>(
-                    (register_y + row) * current_width + (register_x + col))};
-                if (display.at(idx) == 0x01) {
-                    registers.at(FLAG_REGISTER_IDX) = 1;
-                }
-                display.at(idx) ^= 1;
-            }
+    bool collision{false};
+    // Draw whole sprite rows at once, clipping rows past the bottom of the screen
+    for (std::uint8_t row = 0; row < n_row && register_y + row < display.height(); row++) {
+        std::uint16_t sprite{0};
+        if (is_super_chip) {
+            sprite = static_cast<std::uint16_t>(memory.at(index_register + (2 * row)) << 8 |
+                                                memory.at(index_register + (2 * row) + 1));
+        } else {
+            sprite = memory.at(index_register + row);
         }
+
+        collision |= display.draw_row(register_x, register_y + row, sprite, n_col);
     }
+
+    registers.at(FLAG_REGISTER_IDX) = collision ? 1 : 0;
 }
 
 void System::spr_vx(Instruction const instruction) noexcept {
@@ -294,7 +235,12 @@ void System::mov_dt_vx(Instruction const instruction) noexcept {
 }
 
 void System::mov_st_vx(Instruction const instruction) noexcept {
+    bool const was_sounding{sound_timer > 0};
     sound_timer = registers.at(instruction.x());
+
+    if ((sound_timer > 0) != was_sounding) {
+        events.push(sound_timer > 0 ? Event::SOUND_ON : Event::SOUND_OFF);
+    }
 }
 
 void System::add_i_vx(Instruction const instruction) noexcept {
@@ -315,25 +261,45 @@ void System::mov_i_bcd_vx(Instruction const instruction) noexcept {
     memory.at(index_register) = registers.at(instruction.x()) / 100;
     memory.at(index_register + 1) = (registers.at(instruction.x()) / 10) % 10;
     memory.at(index_register + 2) = registers.at(instruction.x()) % 10;
+
+    dirty_pages |= page_mask(index_register, 3);
 }
 
-void System::mov_i_vx(Instruction const instruction) noexcept {
+template <bool MemoryQuirk> void System::mov_i_vx(Instruction const instruction) noexcept {
     for (size_t idx{0}; idx <= instruction.x(); idx++) {
         memory.at(index_register + idx) = registers.at(idx);
     }
 
-    if (!Config::memory_quirk) {
+    dirty_pages |= page_mask(index_register, instruction.x() + 1);
+
+    if constexpr (!MemoryQuirk) {
         index_register = instruction.x() + 1;
     }
 }
 
-void System::mov_vx_i(Instruction const instruction) noexcept {
+template <bool MemoryQuirk> void System::mov_vx_i(Instruction const instruction) noexcept {
     for (size_t idx{0}; idx <= instruction.x(); idx++) {
         registers.at(idx) = memory.at(index_register + idx);
     }
 
-    if (!Config::memory_quirk) {
+    if constexpr (!MemoryQuirk) {
         index_register = instruction.x() + 1;
     }
 }
+
+template void System::shr_vx_vy<false>(Instruction instruction) noexcept;
+template void System::shr_vx_vy<true>(Instruction instruction) noexcept;
+template void System::shl_vx_vy<false>(Instruction instruction) noexcept;
+template void System::shl_vx_vy<true>(Instruction instruction) noexcept;
+template void System::jmp_vx_nnn<false>(Instruction instruction) noexcept;
+template void System::jmp_vx_nnn<true>(Instruction instruction) noexcept;
+template void System::mov_i_vx<false>(Instruction instruction) noexcept;
+template void System::mov_i_vx<true>(Instruction instruction) noexcept;
+template void System::mov_vx_i<false>(Instruction instruction) noexcept;
+template void System::mov_vx_i<true>(Instruction instruction) noexcept;
+
+void System::invalid(Instruction const instruction) noexcept {
+    std::println(stderr, "Error: Invalid (or unimplemented) CHIP-8 instruction: 0x{:04X}",
+                 instruction.raw_data());
+}
 } // namespace Chip8
\ No newline at end of file
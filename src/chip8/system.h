@@ -1,30 +1,47 @@
 #ifndef CHIP8_SYSTEM_H
 #define CHIP8_SYSTEM_H
 
+#include "event_queue.h"
+#include "framebuffer.h"
 #include "instruction.h"
+#include "random.h"
 
+#include <algorithm>
 #include <array>
-#include <functional>
-#include <random>
-#include <stack>
-#include <vector>
+#include <cstdint>
+#include <type_traits>
 
 namespace Chip8 {
-enum class CallbackType : std::uint8_t {
-    CHIP8_CALLBACK_EXIT,
-    CHIP8_CALLBACK_LORES,
-    CHIP8_CALLBACK_HIRES,
+/**
+ * @brief A fault raised by an instruction which cannot complete. The instruction leaves the state
+ * as it was, other than the program counter having moved past it, and the emulator throws once it
+ * has executed.
+ */
+enum class Fault : std::uint8_t {
+    NONE,
+    STACK_OVERFLOW,
+    STACK_UNDERFLOW,
 };
 
-class System {
+struct SaveState;
+
+/**
+ * @brief Architectural state of a CHIP-8 machine, and the instructions which operate on it. It is
+ * trivially copyable with no heap allocations, so copying a system, such as to snapshot it or
+ * verify compiled code against it, is a plain memory copy. The state used by most instructions is
+ * kept together in the first cache line.
+ */
+class alignas(64) System {
 private:
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_int_distribution<std::uint8_t> dist{0};
+    friend struct SaveState;
 
 public:
     System() = default;
 
     static constexpr std::uint16_t MEMORY_SIZE{4096};
+    // Programs are loaded at, and start executing from, PROGRAM_START
+    static constexpr std::uint16_t PROGRAM_START{0x200};
+    static constexpr std::uint16_t MAX_ROM_SIZE{MEMORY_SIZE - PROGRAM_START};
     static constexpr std::uint8_t REGISTER_COUNT{16};
     static constexpr std::uint8_t NUM_KEYS{0x10};
 
@@ -34,30 +51,67 @@ public:
     static constexpr std::uint8_t HIRES_HEIGHT{64};
 
     static constexpr std::uint8_t FLAG_REGISTER_IDX{0xF};
+    static constexpr std::uint8_t STACK_DEPTH{16};
+
+    static constexpr std::uint16_t PAGE_SIZE{0x100};
+    static constexpr std::uint8_t PAGE_COUNT{MEMORY_SIZE / PAGE_SIZE};
+    static constexpr std::uint16_t ALL_PAGES{0xFFFF};
+
+    /**
+     * @brief Compute the mask of the memory pages which a range of memory spans, where bit N
+     * represents page N. Addresses beyond the end of memory are ignored.
+     */
+    [[nodiscard]] static constexpr std::uint16_t page_mask(std::uint16_t const address,
+                                                           std::uint16_t const length) noexcept {
+        if (length == 0 || address >= MEMORY_SIZE) {
+            return 0;
+        }
+
+        std::uint16_t const last{static_cast<std::uint16_t>(
+            std::min<std::uint32_t>(address + length, MEMORY_SIZE) - 1)};
+
+        std::uint16_t mask{0};
+        for (std::uint16_t page = address / PAGE_SIZE; page <= last / PAGE_SIZE; ++page) {
+            mask |= static_cast<std::uint16_t>(1U << page);
+        }
+        return mask;
+    }
 
-    std::array<std::uint8_t, MEMORY_SIZE> memory{};
     std::uint16_t program_counter{0};
     std::uint16_t index_register{0};
-    std::stack<std::uint16_t> stack;
+    std::array<std::uint8_t, REGISTER_COUNT> registers{};
     std::uint8_t delay_timer{0};
     std::uint8_t sound_timer{0};
-    std::array<std::uint8_t, REGISTER_COUNT> registers{};
+    // Number of return addresses on the stack, of which the most recent is stack[stack_depth - 1]
+    std::uint8_t stack_depth{0};
+    Fault fault{Fault::NONE};
+    // Mask of the memory pages written by instructions, so that decoded code can be invalidated
+    std::uint16_t dirty_pages{0};
+    std::array<std::uint16_t, STACK_DEPTH> stack{};
 
     std::array<std::uint8_t, NUM_KEYS> keys{};
     std::uint8_t key_released{0xFF};
     bool waiting{false};
 
-    std::vector<std::uint8_t> display;
-    std::uint8_t current_width{LORES_WIDTH};
-    std::uint8_t current_height{LORES_HEIGHT};
+    Framebuffer display{LORES_WIDTH, LORES_HEIGHT};
 
-    using CallbackFunction = std::function<void(CallbackType callback_type)>;
-    CallbackFunction callback_function;
+    std::array<std::uint8_t, MEMORY_SIZE> memory{};
 
-    // Callback function
-    void set_callback(CallbackFunction callback_function) {
-        this->callback_function = callback_function;
-    }
+private:
+    Random rng{};
+
+public:
+    // Events for the host, such as the program exiting, drained between batches of instructions
+    EventQueue events;
+
+    /**
+     * @brief Reseed the random number generator. Every system starts from the same fixed seed, so
+     * hosts wanting varied runs seed it themselves.
+     */
+    void seed(std::uint32_t const value) { rng.seed(value); }
+
+    /** @brief State of the random number generator, for comparing systems. */
+    [[nodiscard]] Random const& random() const noexcept { return rng; }
 
     void sc_down(Instruction instruction) noexcept;
     void cls(Instruction instruction) noexcept;
@@ -80,12 +134,12 @@ public:
     void xor_vx_vy(Instruction instruction) noexcept;
     void add_vx_vy(Instruction instruction) noexcept;
     void sub_vx_vy(Instruction instruction) noexcept;
-    void shr_vx_vy(Instruction instruction) noexcept;
+    template <bool ShiftQuirk> void shr_vx_vy(Instruction instruction) noexcept;
     void rsb_vx_vy(Instruction instruction) noexcept;
-    void shl_vx_vy(Instruction instruction) noexcept;
+    template <bool ShiftQuirk> void shl_vx_vy(Instruction instruction) noexcept;
     void sne_vx_vy(Instruction instruction) noexcept;
     void mov_i_nnn(Instruction instruction) noexcept;
-    void jmp_vx_nnn(Instruction instruction) noexcept;
+    template <bool JumpQuirk> void jmp_vx_nnn(Instruction instruction) noexcept;
     void rnd_vx_nn(Instruction instruction) noexcept;
     void drw(Instruction instruction) noexcept;
     void spr_vx(Instruction instruction) noexcept;
@@ -98,8 +152,12 @@ public:
     void mov_i_font_vx(Instruction instruction) noexcept;
     void mov_i_bfont_vx(Instruction instruction) noexcept;
     void mov_i_bcd_vx(Instruction instruction) noexcept;
-    void mov_i_vx(Instruction instruction) noexcept;
-    void mov_vx_i(Instruction instruction) noexcept;
+    template <bool MemoryQuirk> void mov_i_vx(Instruction instruction) noexcept;
+    template <bool MemoryQuirk> void mov_vx_i(Instruction instruction) noexcept;
+
+    void invalid(Instruction instruction) noexcept;
 };
+
+static_assert(std::is_trivially_copyable_v<System>, "Systems are copied as plain memory");
 } // namespace Chip8
 #endif // CHIP8_SYSTEM_H
@@ -1,25 +1,145 @@
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <optional>
 #include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
+#include "chip8/config.h"
+#include "chip8/parse.h"
+#include "chip8/rom_database.h"
+#include "chip8/rom_library.h"
 #include "window/window.h"
 
-int main(int const argc, char const* const argv[]) {
-    std::string filename{};
-    // Right now, only want to get the rom path
+namespace {
+constexpr std::string_view USAGE{
+    "Usage: chip8-app [options] <rom>\n"
+    "  --seed <n>       seed for the random number generator (default: random)\n"
+    "  --record <path>  record input to a log, for replaying with chip8-batch --replay\n"
+    "  --profile <path> profile the ROM, writing folded stacks to path.folded and an address\n"
+    "                   heat map to path.heat on exit\n"
+    "  --speed <x>      emulation speed as a multiple of 60hz, from 0.01 to 100 (default 1)\n"
+    "  --turbo          start in turbo mode, emulating as fast as possible (toggle with tab)\n"
+    "  --rom-db <path>  look the ROM up in a database of profiles, to run it with its intended\n"
+    "                   quirks, instructions per frame and colours\n"
+    "  --quirks <name>  chip8, schip or xochip, overriding the ROM's profile (default: schip)\n"
+    "  --ipf <n>        instructions per frame, overriding the ROM's profile (default: 15)"};
+
+/** @brief Command line options of the app. */
+struct AppOptions {
+    std::string filename;
+    WindowOptions window;
+    std::string rom_db;
+    // Overrides of the ROM's profile
+    std::optional<Chip8::Config> quirks;
+    std::optional<std::uint16_t> ipf;
+};
+
+std::optional<AppOptions> parse_options(int const argc, char const* const argv[]) {
+    AppOptions options{};
+
     for (int i = 1; i < argc; i++) {
-        if (i == argc - 1) {
-            filename = argv[i];
+        std::string_view const arg{argv[i]};
+
+        if (!arg.starts_with("--")) {
+            // The rom path is the last argument
+            if (i != argc - 1) {
+                return std::nullopt;
+            }
+            options.filename = arg;
+            continue;
+        }
+
+        if (arg == "--turbo") {
+            options.window.turbo = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            return std::nullopt;
+        }
+        std::string_view const value{argv[++i]};
+
+        if (arg == "--seed" && Chip8::parse_number<std::uint32_t>(value)) {
+            options.window.seed = Chip8::parse_number<std::uint32_t>(value);
+        } else if (arg == "--record") {
+            options.window.record_path = value;
+        } else if (arg == "--profile") {
+            options.window.profile_prefix = value;
+        } else if (arg == "--speed" &&
+                   Chip8::parse_number<double>(value) >= WindowOptions::MIN_SPEED &&
+                   Chip8::parse_number<double>(value) <= WindowOptions::MAX_SPEED) {
+            options.window.speed = *Chip8::parse_number<double>(value);
+        } else if (arg == "--rom-db") {
+            options.rom_db = value;
+        } else if (arg == "--quirks" && Chip8::Config::named(value)) {
+            options.quirks = Chip8::Config::named(value);
+        } else if (arg == "--ipf" && Chip8::parse_number<std::uint16_t>(value) > 0) {
+            options.ipf = Chip8::parse_number<std::uint16_t>(value);
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    return options;
+}
+
+/** @brief Find the profile of the ROM in the database if given one, then apply any overrides. */
+Chip8::RomProfile select_profile(AppOptions const& options) {
+    Chip8::RomProfile profile{};
+
+    if (!options.rom_db.empty()) {
+        Chip8::RomDatabase const database{Chip8::RomDatabase::read(options.rom_db)};
+        Chip8::MappedRom const rom{options.filename};
+
+        if (Chip8::RomProfile const* const found{database.find(Chip8::rom_hash(rom.bytes()))}) {
+            profile = *found;
+            std::println("Using ROM profile: {}",
+                         profile.name.empty() ? "(unnamed)" : profile.name);
+        } else {
+            std::println("ROM not in the database, using the default profile");
         }
     }
 
-    if (!std::filesystem::exists(filename)) {
-        std::println(stderr, "Error: file not found at path: {}", filename);
+    if (options.quirks) {
+        std::uint16_t const tick_rate{profile.config.tick_rate};
+        profile.config = *options.quirks;
+        profile.config.tick_rate = tick_rate;
+    }
+    if (options.ipf) {
+        profile.config.tick_rate = *options.ipf;
+    }
+
+    return profile;
+}
+} // namespace
+
+int main(int const argc, char const* const argv[]) {
+    std::optional<AppOptions> const options{parse_options(argc, argv)};
+    if (!options) {
+        std::println(stderr, "{}", USAGE);
+
+        return EXIT_FAILURE;
+    }
+
+    if (!std::filesystem::exists(options->filename)) {
+        std::println(stderr, "Error: file not found at path: {}", options->filename);
+
+        return EXIT_FAILURE;
+    }
+
+    WindowOptions window_options{options->window};
+    try {
+        window_options.profile = select_profile(*options);
+    } catch (std::runtime_error const& error) {
+        std::println(stderr, "{}", error.what());
 
         return EXIT_FAILURE;
     }
 
-    Window window{filename};
+    Window window{options->filename, window_options};
 
     window.main_loop();
 
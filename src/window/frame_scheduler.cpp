@@ -0,0 +1,34 @@
+#include "frame_scheduler.h"
+
+#include <cstdint>
+#include <thread>
+
+FrameScheduler::FrameScheduler(Clock::duration const period, std::uint32_t const max_catch_up,
+                               Clock::duration const spin_margin)
+    : period{period}, spin_margin{spin_margin}, max_catch_up{max_catch_up},
+      deadline{Clock::now() + period} {}
+
+std::uint32_t FrameScheduler::wait_next_frame() {
+    auto now{Clock::now()};
+
+    if (now < deadline) {
+        // Sleep for most of the wait, as sleeps may overshoot, then spin for the remainder
+        if (deadline - now > spin_margin) {
+            std::this_thread::sleep_until(deadline - spin_margin);
+        }
+        while ((now = Clock::now()) < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    auto const frames_due{static_cast<std::uint64_t>(1 + ((now - deadline) / period))};
+
+    if (frames_due > max_catch_up) {
+        // Too far behind to catch up, so drop the excess frames and continue from now
+        deadline = now + period;
+        return max_catch_up;
+    }
+
+    deadline += frames_due * period;
+    return static_cast<std::uint32_t>(frames_due);
+}
@@ -0,0 +1,37 @@
+#ifndef CHIP8_FRAME_SCHEDULER_H
+#define CHIP8_FRAME_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Fixed step frame scheduler. Sleeps until each frame is due on the monotonic clock, using
+ * a short spin at the end of the sleep to absorb wake up jitter. When running behind, reports
+ * several frames as due so emulation can catch up, up to a bound, beyond which frames are dropped
+ * rather than spiralling further behind.
+ */
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::duration period;
+    Clock::duration spin_margin;
+    std::uint32_t max_catch_up;
+
+    Clock::time_point deadline;
+
+public:
+    explicit FrameScheduler(Clock::duration period, std::uint32_t max_catch_up = 4,
+                            Clock::duration spin_margin = std::chrono::microseconds{500});
+
+    /**
+     * @brief Wait until the next frame is due, and return how many frames are due. This is one
+     * when keeping up, and at most max_catch_up when behind.
+     */
+    std::uint32_t wait_next_frame();
+
+    /** @brief Restart scheduling from now, forgetting any frames the caller is behind by. */
+    void reset() { deadline = Clock::now() + period; }
+};
+#endif // CHIP8_FRAME_SCHEDULER_H
@@ -0,0 +1,49 @@
+#ifndef CHIP8_SPSC_QUEUE_H
+#define CHIP8_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+/**
+ * @brief Lock free bounded queue for one producer thread and one consumer thread. Pushing to a full
+ * queue fails rather than blocking.
+ */
+template <typename T, std::size_t CAPACITY> class SpscQueue {
+private:
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "capacity must be a power of two");
+
+    std::array<T, CAPACITY> items{};
+
+    // Free running positions, wrapped into the array with a mask
+    alignas(64) std::atomic<std::size_t> head{0}; // next item to pop, written by the consumer
+    alignas(64) std::atomic<std::size_t> tail{0}; // next slot to push, written by the producer
+
+public:
+    /** @brief Push an item from the producer thread. Returns false if the queue is full. */
+    bool push(T const& item) {
+        std::size_t const position{tail.load(std::memory_order_relaxed)};
+        if (position - head.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+
+        items.at(position & (CAPACITY - 1)) = item;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief Pop an item from the consumer thread, if there is one. */
+    std::optional<T> pop() {
+        std::size_t const position{head.load(std::memory_order_relaxed)};
+        if (position == tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        T item{items.at(position & (CAPACITY - 1))};
+        head.store(position + 1, std::memory_order_release);
+        return item;
+    }
+};
+#endif // CHIP8_SPSC_QUEUE_H
@@ -0,0 +1,52 @@
+#ifndef CHIP8_TRIPLE_BUFFER_H
+#define CHIP8_TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Lock free triple buffer, passing the latest value from one producer thread to one consumer
+ * thread. The producer writes into a back buffer and publishes it, the consumer takes the most
+ * recently published buffer, and neither ever waits for the other. Intermediate values published
+ * between two takes are skipped.
+ */
+template <typename T> class TripleBuffer {
+private:
+    // Set in the shared index when it holds a value the consumer has not taken yet
+    static constexpr std::uint8_t FRESH{0x4};
+    static constexpr std::uint8_t INDEX_MASK{0x3};
+
+    std::array<T, 3> buffers{};
+
+    // Index of the buffer not owned by either side, plus the fresh flag
+    alignas(64) std::atomic<std::uint8_t> shared{1};
+
+    // Owned by the producer
+    alignas(64) std::uint8_t back_index{0};
+    // Owned by the consumer
+    alignas(64) std::uint8_t front_index{2};
+
+public:
+    /** @brief The buffer for the producer to write into before publishing. */
+    T& back() { return buffers.at(back_index); }
+
+    /** @brief Publish the back buffer, and swap in a buffer to write the next value into. */
+    void publish() {
+        back_index = shared.exchange(back_index | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /** @brief Take the latest published buffer if there is one. Returns whether front changed. */
+    bool take() {
+        if ((shared.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+
+        front_index = shared.exchange(front_index, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /** @brief The buffer most recently taken by the consumer. */
+    T const& front() const { return buffers.at(front_index); }
+};
+#endif // CHIP8_TRIPLE_BUFFER_H
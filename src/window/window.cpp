@@ -1,18 +1,42 @@
 #include "window.h"
 
+#include <atomic>
+#include <bit>
 #include <chrono>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
 #include <memory>
+#include <print>
+#include <random>
 #include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
 
 #include <SDL3/SDL_events.h>
 #include <SDL3/SDL_render.h>
 
 #include "beeper.h"
 #include "chip8/emulator.h"
+#include "chip8/input_log.h"
+#include "chip8/profiler.h"
+#include "chip8/rewind_buffer.h"
+#include "chip8/save_state.h"
+#include "frame_scheduler.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
 
-Window::Window(std::string_view const filename) : sdl_context{SDL_INIT_VIDEO | SDL_INIT_AUDIO} {
+Window::Window(std::string_view const filename, WindowOptions const& options)
+    : sdl_context{SDL_INIT_VIDEO | SDL_INIT_AUDIO}, pixel_on{options.profile.foreground},
+      pixel_off{options.profile.background},
+      title{options.profile.name.empty() ? WINDOW_NAME
+                                         : WINDOW_NAME + " - " + options.profile.name},
+      record_path{options.record_path}, profile_prefix{options.profile_prefix},
+      frame_period{period_at(options.speed)} {
     window = SDLWrappedPtr<SDL_Window, SDL_DestroyWindow>{
-        SDL_CreateWindow(WINDOW_NAME.c_str(), DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT,
+        SDL_CreateWindow(title.c_str(), DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT,
                          SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE)};
 
     if (!window) {
@@ -27,26 +51,68 @@ Window::Window(std::string_view const filename) : sdl_context{SDL_INIT_VIDEO | S
                                  SDL_GetError()};
     }
 
+    texture = SDLWrappedPtr<SDL_Texture, SDL_DestroyTexture>{
+        SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                          Chip8::Framebuffer::MAX_WIDTH, Chip8::Framebuffer::MAX_HEIGHT)};
+
+    if (!texture) {
+        throw std::runtime_error{std::string("Error: failed to create texture: ") +
+                                 SDL_GetError()};
+    }
+
+    SDL_SetTextureScaleMode(texture.get(), SDL_SCALEMODE_NEAREST);
+
     SDL_SetRenderLogicalPresentation(renderer.get(), Chip8::System::LORES_WIDTH,
                                      Chip8::System::LORES_HEIGHT,
                                      SDL_LOGICAL_PRESENTATION_INTEGER_SCALE);
 
     beeper = std::make_unique<Beeper>();
 
-    chip8_emulator = std::make_unique<Chip8::Emulator>();
-    init_callback();
+    chip8_emulator = std::make_unique<Chip8::Emulator>(options.profile.config);
     chip8_emulator->loadRom(filename);
+
+    std::uint32_t const seed{options.seed.value_or(std::random_device{}())};
+    chip8_emulator->system.seed(seed);
+
+    if (!profile_prefix.empty()) {
+        profiler.emplace();
+    }
+
+    if (!record_path.empty()) {
+        recording.emplace(Chip8::InputLog{
+            .config = chip8_emulator->getConfig(), .seed = seed, .instructions = 0, .events = {}});
+    }
+
+    set_turbo(options.turbo);
 }
 
-void Window::parse_keymap(std::uint8_t const key, std::uint8_t const status) const {
+FrameScheduler::Clock::duration Window::period_at(double const speed) {
+    // Written so that NaN fails too
+    if (!(speed >= WindowOptions::MIN_SPEED && speed <= WindowOptions::MAX_SPEED)) {
+        throw std::runtime_error{std::format("Error: speed must be from {} to {}",
+                                             WindowOptions::MIN_SPEED, WindowOptions::MAX_SPEED)};
+    }
+
+    return std::chrono::round<FrameScheduler::Clock::duration>(
+        std::chrono::duration<double>{1.0 / (FPS * speed)});
+}
+
+void Window::parse_keymap(std::uint8_t const key, std::uint8_t const status) {
     auto find_key{KEYMAP.find(key)};
     if (find_key != KEYMAP.end()) {
-        // For waiting
-        if (chip8_emulator->system.waiting && status == 0x0) {
-            chip8_emulator->system.key_released = find_key->second;
-        }
+        // Dropping a key when the emulation thread is far behind is better than blocking on it
+        key_events.push(KeyEvent{.key = find_key->second, .status = status});
+    }
+}
 
-        chip8_emulator->system.keys.at(find_key->second) = status;
+void Window::apply_key_events() {
+    while (auto const event{key_events.pop()}) {
+        bool const pressed{event->status != 0x0};
+        chip8_emulator->setKey(event->key, pressed);
+
+        if (recording) {
+            recording->record(chip8_emulator->getInstructionCount(), event->key, pressed);
+        }
     }
 }
 
@@ -58,10 +124,26 @@ void Window::poll_events() {
             running = false;
             break;
         case SDL_EVENT_KEY_DOWN:
-            parse_keymap(event.key.scancode, 0x1);
+            if (event.key.scancode == REWIND_KEY) {
+                rewinding.store(true, std::memory_order_relaxed);
+            } else if (event.key.scancode == TURBO_KEY) {
+                if (!event.key.repeat) {
+                    set_turbo(!turbo.load(std::memory_order_relaxed));
+                }
+            } else {
+                parse_keymap(event.key.scancode, 0x1);
+            }
             break;
         case SDL_EVENT_KEY_UP:
-            parse_keymap(event.key.scancode, 0x0);
+            if (event.key.scancode == REWIND_KEY) {
+                rewinding.store(false, std::memory_order_relaxed);
+            } else {
+                parse_keymap(event.key.scancode, 0x0);
+            }
+            break;
+        case SDL_EVENT_WINDOW_EXPOSED:
+        case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+            redraw = true;
             break;
         default:
             break;
@@ -70,85 +152,241 @@ void Window::poll_events() {
 }
 
 void Window::clear() const {
-    SDL_SetRenderDrawColor(renderer.get(), 0x00, 0x00, 0x00, 0xFF);
+    // Fill the margins around the display with the background colour
+    SDL_SetRenderDrawColor(renderer.get(), static_cast<std::uint8_t>(pixel_off >> 16),
+                           static_cast<std::uint8_t>(pixel_off >> 8),
+                           static_cast<std::uint8_t>(pixel_off), 0xFF);
     SDL_RenderClear(renderer.get());
 }
 
-void Window::draw() const {
-    SDL_SetRenderDrawColor(renderer.get(), 0xFF, 0xFF, 0xFF, 0xFF);
+bool Window::update_texture() {
+    Chip8::Framebuffer const& display{frames.front().display};
 
-    for (size_t x{0}; x < chip8_emulator->system.current_width; ++x) {
-        for (size_t y{0}; y < chip8_emulator->system.current_height; ++y) {
-            if (chip8_emulator->system.display.at((y * chip8_emulator->system.current_width) + x) ==
-                1) {
-                SDL_RenderPoint(renderer.get(), x, y);
-            }
+    bool const resized{!texture_current || display.width() != shown.display.width() ||
+                       display.height() != shown.display.height()};
+
+    // Frames may be skipped, so find the changed rows by comparing against the texture's contents
+    std::uint64_t dirty{resized ? Chip8::Framebuffer::ALL_ROWS : 0};
+    for (std::uint8_t y{0}; !resized && y < Chip8::Framebuffer::MAX_HEIGHT; ++y) {
+        if (display.row(y) != shown.display.row(y)) {
+            dirty |= std::uint64_t{1} << y;
         }
     }
+    if (dirty == 0) {
+        return false;
+    }
+
+    if (resized) {
+        SDL_SetRenderLogicalPresentation(renderer.get(), display.width(), display.height(),
+                                         SDL_LOGICAL_PRESENTATION_INTEGER_SCALE);
+    }
+
+    // Locked pixels are write only, so upload the whole band from the first to last dirty row
+    int const first{std::countr_zero(dirty)};
+    int const last{(Chip8::Framebuffer::MAX_HEIGHT - 1) - std::countl_zero(dirty)};
+    SDL_Rect const band{
+        .x = 0, .y = first, .w = Chip8::Framebuffer::MAX_WIDTH, .h = last - first + 1};
+
+    void* pixels{nullptr};
+    int pitch{0};
+    if (!SDL_LockTexture(texture.get(), &band, &pixels, &pitch)) {
+        // Try again next frame
+        texture_current = false;
+        return false;
+    }
+
+    for (int y{first}; y <= last; ++y) {
+        auto* const line{reinterpret_cast<std::uint32_t*>(static_cast<std::uint8_t*>(pixels) +
+                                                          ((y - first) * pitch))};
+
+        for (std::uint8_t x{0}; x < Chip8::Framebuffer::MAX_WIDTH; ++x) {
+            line[x] = display.pixel(x, static_cast<std::uint8_t>(y)) ? pixel_on : pixel_off;
+        }
+    }
+
+    SDL_UnlockTexture(texture.get());
+
+    shown = frames.front();
+    texture_current = true;
+
+    return true;
+}
+
+void Window::draw() const {
+    Chip8::Framebuffer const& display{shown.display};
+
+    SDL_FRect const source{.x = 0,
+                           .y = 0,
+                           .w = static_cast<float>(display.width()),
+                           .h = static_cast<float>(display.height())};
+
+    SDL_RenderTexture(renderer.get(), texture.get(), &source, nullptr);
 }
 
 void Window::present() const { SDL_RenderPresent(renderer.get()); }
 
-void Window::init_callback() const {
-    chip8_emulator->system.set_callback([this](Chip8::CallbackType const callback_type) {
-        switch (callback_type) {
-        case Chip8::CallbackType::CHIP8_CALLBACK_EXIT: {
-            // Call a quit event to ensure all quit handling is done in the same place.
-            SDL_Event event{};
-            event.type = SDL_EVENT_QUIT;
-            SDL_PushEvent(&event);
+void Window::drain_events() {
+    while (auto const event{chip8_emulator->system.events.pop()}) {
+        switch (*event) {
+        case Chip8::Event::EXIT: {
+            exited = true;
+
+            // Quit through the render thread, so that all quit handling is done in the same place
+            SDL_Event quit{};
+            quit.type = SDL_EVENT_QUIT;
+            SDL_PushEvent(&quit);
             break;
         }
-        case Chip8::CallbackType::CHIP8_CALLBACK_HIRES:
-            SDL_SetRenderLogicalPresentation(renderer.get(), Chip8::System::HIRES_WIDTH,
-                                             Chip8::System::HIRES_HEIGHT,
-                                             SDL_LOGICAL_PRESENTATION_INTEGER_SCALE);
+        case Chip8::Event::SOUND_ON:
+            sounding = true;
+            break;
+        case Chip8::Event::SOUND_OFF:
+            sounding = false;
             break;
-        case Chip8::CallbackType::CHIP8_CALLBACK_LORES:
-            SDL_SetRenderLogicalPresentation(renderer.get(), Chip8::System::LORES_WIDTH,
-                                             Chip8::System::LORES_HEIGHT,
-                                             SDL_LOGICAL_PRESENTATION_INTEGER_SCALE);
+        case Chip8::Event::LORES:
+        case Chip8::Event::HIRES:
+        case Chip8::Event::FRAME_READY:
+            // The render thread follows the resolution of each published frame, and frames are
+            // published once per batch of frames
             break;
         }
-    });
+    }
 }
 
-void Window::main_loop() {
-    using namespace std::chrono;
+void Window::emulate_frame() {
+    apply_key_events();
 
-    auto current_time{system_clock::now()};
-    auto fps_time{current_time};
-    auto cycle_time{current_time};
+    // Step back one frame per frame while rewinding, stopping at the oldest recorded state
+    if (!recording && rewinding.load(std::memory_order_relaxed)) {
+        if (rewind.pop(rewind_state)) {
+            chip8_emulator->loadState(rewind_state);
 
-    while (running) {
-        current_time = system_clock::now();
+            // Restoring a state raises no events, so follow the restored sound timer
+            sounding = chip8_emulator->system.sound_timer > 0;
+        }
+        return;
+    }
 
-        // Target fps to reach the expected 60hz for chip8
-        static constexpr double FPS{60};
-        // Tick rate at standard default for now, to be configured game by game
-        static constexpr double TICK_RATE{15.0};
+    if (profiler) {
+        profiler->run(*chip8_emulator, chip8_emulator->getConfig().tick_rate);
+        chip8_emulator->updateTimers();
+    } else {
+        chip8_emulator->runFrame();
+    }
 
-        static constexpr auto FPS_STEP{round<system_clock::duration>(duration<double>{1.0 / FPS})};
-        static constexpr auto CYCLE_STEP{
-            round<system_clock::duration>(duration<double>{1.0 / (FPS * TICK_RATE)})};
+    drain_events();
+    if (sounding) {
+        beeper->beep();
+    }
 
-        if (current_time > cycle_time + CYCLE_STEP) {
-            chip8_emulator->cycle();
+    if (recording) {
+        return;
+    }
 
-            cycle_time = current_time;
-        }
+    chip8_emulator->saveState(rewind_state);
+    rewind.push(rewind_state);
+}
+
+void Window::set_turbo(bool const enabled) {
+    turbo.store(enabled, std::memory_order_relaxed);
+
+    std::string const shown_title{enabled ? title + " (turbo)" : title};
+    SDL_SetWindowTitle(window.get(), shown_title.c_str());
+}
 
-        if (current_time > fps_time + FPS_STEP) {
-            if (chip8_emulator->updateTimers()) {
-                beeper->beep();
+void Window::publish_frame() {
+    // Only publish when the display has changed
+    Chip8::Framebuffer& display{chip8_emulator->system.display};
+    if (display.take_dirty_rows() != 0) {
+        frames.back().display = display;
+        frames.publish();
+    }
+}
+
+void Window::emulation_loop(std::stop_token const& stop) {
+    FrameScheduler scheduler{frame_period};
+    bool was_turbo{false};
+
+    while (!stop.stop_requested() && !exited) {
+        if (turbo.load(std::memory_order_relaxed)) {
+            // Run flat out, only publishing every few frames as the render thread shows at most
+            // one per refresh. Timers still tick once per emulated frame, so the program sees
+            // time pass at its normal rate relative to the instructions it runs
+            for (std::uint32_t frame{0}; frame < TURBO_FRAME_SKIP && !exited; ++frame) {
+                emulate_frame();
+            }
+            was_turbo = true;
+        } else {
+            // Resume from now, rather than trying to catch up on the time spent in turbo
+            if (was_turbo) {
+                scheduler.reset();
+                was_turbo = false;
             }
 
+            std::uint32_t const frames_due{scheduler.wait_next_frame()};
+
+            // Run a batch of instructions per frame, catching up on missed frames when behind
+            for (std::uint32_t frame{0}; frame < frames_due && !exited; ++frame) {
+                emulate_frame();
+            }
+        }
+
+        publish_frame();
+    }
+}
+
+void Window::main_loop() {
+    // Emulation runs on its own thread, so a slow present never stalls it
+    std::jthread emulation{[this](std::stop_token const& stop) {
+        try {
+            emulation_loop(stop);
+        } catch (std::exception const& error) {
+            // The program faulted, or ran outside of memory, so there is nothing left to run.
+            // Anything escaping the thread would terminate without tearing down SDL
+            std::println(stderr, "{}", error.what());
+
+            SDL_Event event{};
+            event.type = SDL_EVENT_QUIT;
+            SDL_PushEvent(&event);
+        }
+    }};
+
+    // The render thread never catches up, as only the latest frame matters
+    FrameScheduler scheduler{FRAME_PERIOD, 1};
+
+    while (running) {
+        scheduler.wait_next_frame();
+        poll_events();
+
+        // Only render when the display has changed, or the window needs repainting
+        frames.take();
+        if (update_texture() || redraw) {
             clear();
             draw();
             present();
-            poll_events();
-
-            fps_time = current_time;
+            redraw = false;
         }
     }
+
+    // Stop emulating, so the recording is complete
+    emulation.request_stop();
+    emulation.join();
+
+#ifdef CHIP8_INSTRUMENTATION
+    chip8_emulator->getStats().report(std::cerr);
+#endif
+
+    if (profiler) {
+        profiler->write_files(profile_prefix);
+        std::println("Wrote profile of {} samples to {}.folded and {}.heat",
+                     profiler->sample_count(), profile_prefix, profile_prefix);
+    }
+
+    if (recording) {
+        recording->instructions = chip8_emulator->getInstructionCount();
+        recording->write(record_path);
+        std::println("Recorded {} input events over {} instructions to {}, display hash {:016X}",
+                     recording->events.size(), recording->instructions, record_path,
+                     chip8_emulator->system.display.hash());
+    }
 }
\ No newline at end of file
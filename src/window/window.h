@@ -1,15 +1,49 @@
 #ifndef CHIP8_WINDOW_H
 #define CHIP8_WINDOW_H
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
 #include <unordered_map>
 
 #include <SDL3/SDL.h>
 
 #include "sdl_wrapper.h"
 #include "chip8/emulator.h"
+#include "chip8/input_log.h"
+#include "chip8/profiler.h"
+#include "chip8/rom_database.h"
+#include "chip8/rewind_buffer.h"
+#include "chip8/save_state.h"
 #include "beeper.h"
+#include "frame_scheduler.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+
+/** @brief Options for a window, as given on the command line. */
+struct WindowOptions {
+    // Limits of the speed multiplier, keeping the frame period representable and non-zero
+    static constexpr double MIN_SPEED{0.01};
+    static constexpr double MAX_SPEED{100};
+
+    // Seed for the random number generator, otherwise seeded nondeterministically
+    std::optional<std::uint32_t> seed;
+    // Where to write an input log of the session, for replaying with chip8-batch
+    std::string record_path;
+    // Where to write a profile of the session, as prefix.folded and prefix.heat
+    std::string profile_prefix;
+    // Multiple of the normal 60hz frame rate to emulate at, from MIN_SPEED to MAX_SPEED
+    double speed{1};
+    // Whether to start in turbo mode, emulating as fast as the host allows
+    bool turbo{false};
+    // Quirks, instructions per frame and colours to run the ROM with
+    Chip8::RomProfile profile{};
+};
 
 class Window {
 private:
@@ -18,22 +52,94 @@ private:
 
     static constexpr std::string WINDOW_NAME{"CHIP-8 Emulator"};
 
+    // Target fps to reach the expected 60hz for chip8
+    static constexpr double FPS{60};
+    static constexpr auto FRAME_PERIOD{std::chrono::round<FrameScheduler::Clock::duration>(
+        std::chrono::duration<double>{1.0 / FPS})};
+
+    // Held to step backwards through recent history
+    static constexpr SDL_Scancode REWIND_KEY{SDL_SCANCODE_BACKSPACE};
+    static constexpr std::size_t REWIND_BUDGET{8 * 1024 * 1024};
+
+    // Toggles turbo mode
+    static constexpr SDL_Scancode TURBO_KEY{SDL_SCANCODE_TAB};
+    // Frames emulated per published frame in turbo mode
+    static constexpr std::uint32_t TURBO_FRAME_SKIP{8};
+
+    // A display published by the emulation thread for the render thread
+    struct Frame {
+        Chip8::Framebuffer display{Chip8::System::LORES_WIDTH, Chip8::System::LORES_HEIGHT};
+    };
+
+    // A key press or release, sent from the render thread to the emulation thread
+    struct KeyEvent {
+        std::uint8_t key;
+        std::uint8_t status;
+    };
+
     SDLContext sdl_context;
 
     SDLWrappedPtr<SDL_Window, SDL_DestroyWindow> window;
     SDLWrappedPtr<SDL_Renderer, SDL_DestroyRenderer> renderer;
+    // Copy of the display, updated row by row as the display changes
+    SDLWrappedPtr<SDL_Texture, SDL_DestroyTexture> texture;
+    // Display held by the texture, only valid once texture_current is set
+    Frame shown{};
+    bool texture_current{false};
+    // Whether the window needs presenting even if the display has not changed
+    bool redraw{true};
+    // Colours of on and off pixels, as ARGB8888
+    std::uint32_t pixel_on;
+    std::uint32_t pixel_off;
+    // Window title, naming the ROM if its profile does
+    std::string title;
 
+    // Owned by the emulation thread while main_loop is running
     std::unique_ptr<Beeper> beeper;
     std::unique_ptr<Chip8::Emulator> chip8_emulator;
+    // Whether the sound timer is active, following the emulator's sound events
+    bool sounding{false};
+    // Whether the program has exited, after which no more frames are emulated, so a recording
+    // ends where a replay of it stops
+    bool exited{false};
+
+    // Input recorded for replay, if recording. Rewinding is disabled while recording, as restored
+    // states are not part of the log
+    std::optional<Chip8::InputLog> recording;
+    std::string record_path;
+
+    // Profiler sampling the program, if profiling
+    std::optional<Chip8::Profiler> profiler;
+    std::string profile_prefix;
+
+    Chip8::RewindBuffer rewind{REWIND_BUDGET};
+    Chip8::SaveState rewind_state{};
+
+    // Period of emulated frames, shortened or lengthened by the speed multiplier
+    FrameScheduler::Clock::duration frame_period;
+
+    TripleBuffer<Frame> frames;
+    SpscQueue<KeyEvent, 64> key_events;
+    std::atomic<bool> rewinding{false};
+    std::atomic<bool> turbo{false};
+
+    // Period of an emulated frame at a speed multiplier, throwing if the speed is out of range
+    static FrameScheduler::Clock::duration period_at(double speed);
 
-    void parse_keymap(std::uint8_t key, std::uint8_t status) const;
+    void parse_keymap(std::uint8_t key, std::uint8_t status);
+    void apply_key_events();
+    void emulation_loop(std::stop_token const& stop);
+    void drain_events();
+    void emulate_frame();
+    void publish_frame();
+    void set_turbo(bool enabled);
+    bool update_texture();
 
 public:
     bool running{true};
 
-    explicit Window(std::string_view filename);
+    explicit Window(std::string_view filename, WindowOptions const& options = {});
 
-    void init_callback() const;
     void main_loop();
     void poll_events();
     void clear() const;
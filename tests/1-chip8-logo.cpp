@@ -45,7 +45,7 @@ constexpr std::array<std::uint8_t, 2048> EXPECTED_DISPLAY{
 static void output_display(Chip8::System const& system) {
     for (std::size_t i{0}; i < 32; ++i) {
         for (std::size_t j{0}; j < 64; ++j) {
-            std::cout << static_cast<unsigned>(system.display.at((64 * i) + j)) << ",";
+            std::cout << static_cast<unsigned>(system.display.pixel(j, i)) << ",";
         }
         std::cout << "\n";
     }
@@ -70,6 +70,13 @@ TEST_CASE("Running the 1-chip8-logo.ch8 test rom results in the correct renderin
         ++timeout;
     }
 
-    CHECK(std::equal(EXPECTED_DISPLAY.begin(), EXPECTED_DISPLAY.end(),
-                     emulator.system.display.begin()));
+    bool matches{true};
+    for (std::uint8_t y{0}; y < 32; ++y) {
+        for (std::uint8_t x{0}; x < 64; ++x) {
+            bool const expected{EXPECTED_DISPLAY.at((64 * y) + x) == 1};
+            matches &= emulator.system.display.pixel(x, y) == expected;
+        }
+    }
+
+    CHECK(matches);
 }
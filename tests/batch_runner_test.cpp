@@ -0,0 +1,25 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "../src/batch/batch_runner.h"
+
+TEST_CASE("Batch results quote the ROM path and error in the CSV") {
+    std::vector<Chip8::Batch::Result> const results{
+        {.rom_path = "roms/a, \"b\".ch8",
+         .error = "Error: ROM is 4000 bytes, but at most 3584 fit in memory"}};
+
+    std::ostringstream out{};
+    Chip8::Batch::write_results(out, results);
+
+    std::istringstream lines{out.str()};
+    std::string header{};
+    std::string row{};
+    std::getline(lines, header);
+    std::getline(lines, row);
+
+    CHECK(row.starts_with("\"roms/a, \"\"b\"\".ch8\","));
+    CHECK(row.ends_with(",\"Error: ROM is 4000 bytes, but at most 3584 fit in memory\""));
+}
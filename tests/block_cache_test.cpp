@@ -0,0 +1,82 @@
+#include <array>
+#include <cstdint>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/instruction.h"
+#include "../src/chip8/system.h"
+
+TEST_CASE("Page masks cover every page a range of memory spans") {
+    CHECK_EQ(Chip8::System::page_mask(0x200, 0), 0x0000);
+    CHECK_EQ(Chip8::System::page_mask(0x200, 2), 0x0004);
+    CHECK_EQ(Chip8::System::page_mask(0x2FF, 2), 0x000C);
+    CHECK_EQ(Chip8::System::page_mask(0xFFE, 16), 0x8000);
+}
+
+TEST_CASE("Writing over cached code with FX55 results in the new instructions being executed") {
+    Chip8::Emulator emulator{};
+    emulator.system.program_counter = 0x200;
+
+    // 0x200: V1 = 0x05, 0x202: jump to 0x200
+    emulator.system.memory.at(0x200) = 0x61;
+    emulator.system.memory.at(0x201) = 0x05;
+    emulator.system.memory.at(0x202) = 0x12;
+    emulator.system.memory.at(0x203) = 0x00;
+    emulator.invalidateCache();
+
+    emulator.cycle();
+    emulator.cycle();
+    CHECK_EQ(emulator.system.registers.at(0x1), 0x05);
+    CHECK_EQ(emulator.system.program_counter, 0x200);
+
+    // Overwrite the first instruction with V1 = 0x07 using FX55
+    emulator.system.registers.at(0x0) = 0x61;
+    emulator.system.registers.at(0x1) = 0x07;
+    emulator.system.index_register = 0x200;
+    emulator.decodeInstruction(Chip8::Instruction{0xF155});
+    emulator.system.registers.at(0x1) = 0x00;
+
+    emulator.cycle();
+    CHECK_EQ(emulator.system.registers.at(0x1), 0x07);
+}
+
+TEST_CASE("Skipping idle loops leaves the same state as executing them") {
+    constexpr std::array<std::uint8_t, 16> PROGRAM{
+        0x60, 0x05, // 0x200: V0 = 5
+        0xF0, 0x15, // 0x202: delay timer = V0
+        0xF1, 0x07, // 0x204: V1 = delay timer
+        0x31, 0x00, // 0x206: skip if V1 == 0
+        0x12, 0x04, // 0x208: jump to 0x204
+        0x72, 0x01, // 0x20A: V2 += 1
+        0xF0, 0x0A, // 0x20C: V0 = next released key
+        0x12, 0x0E, // 0x20E: jump to 0x20E
+    };
+
+    Chip8::Emulator skipping{};
+    Chip8::Emulator executing{};
+    executing.setIdleSkipping(false);
+    for (Chip8::Emulator* const emulator : {&skipping, &executing}) {
+        emulator->loadRom(PROGRAM);
+    }
+
+    for (int frame{0}; frame < 20; ++frame) {
+        for (Chip8::Emulator* const emulator : {&skipping, &executing}) {
+            emulator->run(emulator->getConfig().tick_rate + frame);
+            emulator->updateTimers();
+            if (frame == 10) {
+                emulator->setKey(0x7, true);
+                emulator->setKey(0x7, false);
+            }
+        }
+
+        CHECK_EQ(skipping.getInstructionCount(), executing.getInstructionCount());
+        CHECK_EQ(skipping.system.program_counter, executing.system.program_counter);
+        CHECK_EQ(skipping.system.registers, executing.system.registers);
+        CHECK_EQ(skipping.system.waiting, executing.system.waiting);
+    }
+
+    CHECK_EQ(skipping.system.registers.at(0x0), 0x7);
+    CHECK_EQ(skipping.system.registers.at(0x2), 0x1);
+    CHECK_EQ(skipping.system.program_counter, 0x20E);
+}
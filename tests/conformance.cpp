@@ -0,0 +1,342 @@
+/**
+ * Data driven conformance runner. Each line of a manifest names a ROM, the quirks to run it with,
+ * when to stop, the hash of the display expected at that point, and optionally a reference image
+ * of that display, with whitespace separated columns:
+ *
+ *     # rom                       quirks  stop                 hash              reference
+ *     test-roms/1-chip8-logo.ch8  schip   pc=0x24E,cycles=100  6693B27669582246  logo.txt
+ *
+ * The stop condition is a comma separated list of pc=<address>, cycles=<n> and frames=<n>. Without
+ * a pc, the ROM runs for the given cycles or frames. With one, it runs until the program counter
+ * reaches the address, failing if the cycles or frames run out first. A ROM exiting also stops it.
+ * Paths are relative to the manifest. Reference images are rows of '#' for on and '.' for off
+ * pixels, and are only used to show what differs when the hash does not match.
+ *
+ * Entries run in parallel on the batch thread pool, so adding ROMs costs little wall time.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <print>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "batch/thread_pool.h"
+#include "chip8/config.h"
+#include "chip8/emulator.h"
+#include "chip8/framebuffer.h"
+#include "chip8/parse.h"
+#include "chip8/rom_library.h"
+#include "chip8/system.h"
+
+namespace {
+constexpr std::string_view USAGE{
+    "Usage: conformance [options] <manifest>...\n"
+    "  --threads <n>    worker threads (default: all cores)\n"
+    "  --filter <text>  only run entries whose rom path contains text"};
+
+// Limit on a pc stop condition when no cycles or frames are given
+constexpr std::uint64_t DEFAULT_TIMEOUT_FRAMES{60 * 60};
+
+/** @brief A line of a manifest. */
+struct Entry {
+    std::string location; // manifest:line, for reporting
+    std::filesystem::path rom;
+    Chip8::Config config{};
+    std::optional<std::uint16_t> stop_pc;
+    std::uint64_t cycles{0};
+    std::uint64_t hash{0};
+    std::filesystem::path reference;
+};
+
+enum class Status : std::uint8_t { PASS, FAIL, TIMEOUT, ERROR };
+
+/** @brief Outcome of running an entry. The display is only meaningful on PASS or FAIL. */
+struct Outcome {
+    Status status{Status::ERROR};
+    std::uint64_t cycles{0};
+    Chip8::Framebuffer display{Chip8::System::LORES_WIDTH, Chip8::System::LORES_HEIGHT};
+    std::string error;
+};
+
+/** @brief Parse a stop condition into the entry, returning false if it is malformed. */
+bool parse_stop(std::string_view stop, Entry& entry) {
+    std::optional<std::uint64_t> cycles{};
+    std::optional<std::uint64_t> frames{};
+
+    while (!stop.empty()) {
+        std::size_t const comma{std::min(stop.find(','), stop.size())};
+        std::string_view const condition{stop.substr(0, comma)};
+        stop.remove_prefix(std::min(comma + 1, stop.size()));
+
+        std::size_t const equals{condition.find('=')};
+        if (equals == std::string_view::npos) {
+            return false;
+        }
+        std::string_view const key{condition.substr(0, equals)};
+        std::string_view const value{condition.substr(equals + 1)};
+
+        if (key == "pc") {
+            entry.stop_pc = Chip8::parse_number<std::uint16_t>(value, 16);
+        } else if (key == "cycles") {
+            cycles = Chip8::parse_number<std::uint64_t>(value);
+        } else if (key == "frames") {
+            frames = Chip8::parse_number<std::uint64_t>(value);
+        }
+        if ((key == "pc" && !entry.stop_pc) || (key == "cycles" && !cycles) ||
+            (key == "frames" && !frames) || (key != "pc" && key != "cycles" && key != "frames")) {
+            return false;
+        }
+    }
+
+    if (!cycles && !frames && !entry.stop_pc) {
+        return false;
+    }
+    entry.cycles =
+        cycles.value_or(frames.value_or(DEFAULT_TIMEOUT_FRAMES) * entry.config.tick_rate);
+    return true;
+}
+
+std::vector<Entry> read_manifest(std::filesystem::path const& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error{"Error: failed to open manifest: " + path.string()};
+    }
+
+    std::vector<Entry> entries{};
+    std::string line{};
+    for (std::size_t number{1}; std::getline(file, line); ++number) {
+        std::istringstream columns{line};
+        std::string rom{};
+        std::string quirks{};
+        std::string stop{};
+        std::string hash{};
+        std::string reference{};
+
+        if (!(columns >> rom) || rom.starts_with('#')) {
+            continue;
+        }
+        columns >> quirks >> stop >> hash >> reference;
+
+        Entry entry{.location = path.string() + ":" + std::to_string(number),
+                    .rom = path.parent_path() / rom};
+
+        std::optional<Chip8::Config> const config{Chip8::Config::named(quirks)};
+        if (config) {
+            entry.config = *config;
+        }
+        std::optional<std::uint64_t> const expected{Chip8::parse_number<std::uint64_t>(hash, 16)};
+        if (!config || !parse_stop(stop, entry) || !expected) {
+            throw std::runtime_error{"Error: malformed manifest entry at " + entry.location};
+        }
+        entry.hash = *expected;
+        if (!reference.empty()) {
+            entry.reference = path.parent_path() / reference;
+        }
+
+        entries.push_back(std::move(entry));
+    }
+
+    return entries;
+}
+
+Outcome run_entry(Entry const& entry) {
+    Outcome outcome{};
+
+    try {
+        Chip8::MappedRom const rom{entry.rom};
+
+        Chip8::Emulator emulator{entry.config};
+        bool exited{false};
+        emulator.loadRom(rom.bytes());
+
+        // Timers tick at frame boundaries, and a pc stop is checked between every instruction
+        std::uint64_t const tick_rate{std::max<std::uint64_t>(entry.config.tick_rate, 1)};
+        auto const stopped{[&] {
+            return exited || (entry.stop_pc && emulator.system.program_counter == *entry.stop_pc);
+        }};
+
+        while (outcome.cycles < entry.cycles && !stopped()) {
+            std::uint64_t const step{
+                entry.stop_pc ? 1
+                              : std::min(tick_rate - (outcome.cycles % tick_rate),
+                                         entry.cycles - outcome.cycles)};
+            emulator.run(step);
+            outcome.cycles += step;
+
+            while (auto const event{emulator.system.events.pop()}) {
+                exited |= *event == Chip8::Event::EXIT;
+            }
+
+            if (outcome.cycles % tick_rate == 0) {
+                emulator.updateTimers();
+            }
+        }
+
+        outcome.display = emulator.system.display;
+        if (entry.stop_pc && !stopped()) {
+            outcome.status = Status::TIMEOUT;
+        } else {
+            outcome.status = outcome.display.hash() == entry.hash ? Status::PASS : Status::FAIL;
+        }
+    } catch (std::exception const& exception) {
+        outcome.error = exception.what();
+    }
+
+    return outcome;
+}
+
+/** @brief Read a reference image, returning nothing if there is none or it cannot be read. */
+std::optional<std::vector<std::string>> read_reference(std::filesystem::path const& path) {
+    std::ifstream file{path};
+    if (path.empty() || !file) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> rows{};
+    for (std::string row{}; std::getline(file, row);) {
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+/**
+ * @brief Render a display as ASCII. Against a reference, pixels which differ are shown as '+' when
+ * unexpectedly on and '-' when unexpectedly off.
+ */
+std::string render(Chip8::Framebuffer const& display,
+                   std::optional<std::vector<std::string>> const& reference) {
+    std::string text{};
+    std::size_t differences{0};
+
+    for (std::uint8_t y{0}; y < display.height(); ++y) {
+        for (std::uint8_t x{0}; x < display.width(); ++x) {
+            bool const on{display.pixel(x, y)};
+            char pixel{on ? '#' : '.'};
+
+            if (reference) {
+                bool const expected{y < reference->size() && x < (*reference)[y].size() &&
+                                    (*reference)[y][x] == '#'};
+                if (on != expected) {
+                    pixel = on ? '+' : '-';
+                    ++differences;
+                }
+            }
+            text += pixel;
+        }
+        text += '\n';
+    }
+
+    if (reference) {
+        bool const resized{reference->size() != display.height() ||
+                           (!reference->empty() && reference->front().size() != display.width())};
+        text += std::format("{} pixels differ from the reference{}\n", differences,
+                            resized ? ", which has a different resolution" : "");
+    }
+    return text;
+}
+
+void report(Entry const& entry, Outcome const& outcome) {
+    switch (outcome.status) {
+    case Status::PASS:
+        std::println("PASS    {} ({} cycles)", entry.rom.string(), outcome.cycles);
+        return;
+    case Status::ERROR:
+        std::println("ERROR   {} ({}): {}", entry.rom.string(), entry.location, outcome.error);
+        return;
+    case Status::TIMEOUT:
+        std::println("TIMEOUT {} ({}): pc 0x{:03X} not reached within {} cycles",
+                     entry.rom.string(), entry.location, *entry.stop_pc, outcome.cycles);
+        break;
+    case Status::FAIL:
+        std::println("FAIL    {} ({}): display hash {:016X}, expected {:016X}", entry.rom.string(),
+                     entry.location, outcome.display.hash(), entry.hash);
+        break;
+    }
+
+    std::print("{}", render(outcome.display, read_reference(entry.reference)));
+}
+} // namespace
+
+int main(int const argc, char const* const argv[]) {
+    using namespace std::chrono;
+
+    std::size_t threads{std::thread::hardware_concurrency()};
+    std::string filter{};
+    std::vector<std::filesystem::path> manifests{};
+
+    for (int i = 1; i < argc; i++) {
+        std::string_view const arg{argv[i]};
+
+        if (!arg.starts_with("--")) {
+            manifests.emplace_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::println(stderr, "Error: missing value for {}\n{}", arg, USAGE);
+            return EXIT_FAILURE;
+        }
+        std::string_view const value{argv[++i]};
+
+        if (arg == "--threads" && Chip8::parse_number<std::size_t>(value)) {
+            threads = *Chip8::parse_number<std::size_t>(value);
+        } else if (arg == "--filter") {
+            filter = value;
+        } else {
+            std::println(stderr, "Error: invalid option: {} {}\n{}", arg, value, USAGE);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (manifests.empty()) {
+        std::println(stderr, "{}", USAGE);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Entry> entries{};
+    try {
+        for (std::filesystem::path const& manifest : manifests) {
+            std::ranges::copy_if(read_manifest(manifest), std::back_inserter(entries),
+                                 [&filter](Entry const& entry) {
+                                     return entry.rom.string().contains(filter);
+                                 });
+        }
+    } catch (std::runtime_error const& error) {
+        std::println(stderr, "{}", error.what());
+        return EXIT_FAILURE;
+    }
+
+    auto const start{steady_clock::now()};
+
+    std::vector<Outcome> outcomes(entries.size());
+    {
+        Chip8::Batch::ThreadPool pool{threads};
+        for (std::size_t idx{0}; idx < entries.size(); ++idx) {
+            pool.submit([&entries, &outcomes, idx] { outcomes[idx] = run_entry(entries[idx]); });
+        }
+        pool.wait();
+    }
+
+    std::size_t passed{0};
+    for (std::size_t idx{0}; idx < entries.size(); ++idx) {
+        report(entries[idx], outcomes[idx]);
+        passed += outcomes[idx].status == Status::PASS ? 1 : 0;
+    }
+
+    std::println("{} of {} passed in {:.3f}s", passed, entries.size(),
+                 duration<double>{steady_clock::now() - start}.count());
+
+    return passed == entries.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
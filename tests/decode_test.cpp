@@ -0,0 +1,66 @@
+#include <cstdint>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/config.h"
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/instruction.h"
+#include "../src/chip8/instruction_set.h"
+
+TEST_CASE("The dispatch table decodes every instruction to the same function as a linear scan of "
+          "the decode table") {
+    using namespace Chip8::InstructionSet;
+
+    for (std::uint32_t raw{0}; raw <= 0xFFFF; ++raw) {
+        Chip8::Instruction const instruction{static_cast<std::uint16_t>(raw)};
+
+        InstructionFunctionPtr expected{&Chip8::System::invalid};
+        for (auto const& row : DECODE_TABLE<Chip8::SuperChipQuirks>) {
+            if (row.matches(instruction)) {
+                expected = row.execute;
+                break;
+            }
+        }
+
+        REQUIRE(decode<Chip8::SuperChipQuirks>(instruction) == expected);
+    }
+}
+
+TEST_CASE("Quirk policies select functions specialised for their quirks") {
+    using namespace Chip8::InstructionSet;
+
+    CHECK(decode<Chip8::Chip8Quirks>(Chip8::Instruction{0x8126}) ==
+          &Chip8::System::shr_vx_vy<false>);
+    CHECK(decode<Chip8::SuperChipQuirks>(Chip8::Instruction{0x8126}) ==
+          &Chip8::System::shr_vx_vy<true>);
+    CHECK(handlers(true, false, true)[decode_index(Chip8::Instruction{0xF255})] ==
+          &Chip8::System::mov_i_vx<true>);
+    CHECK(handlers(true, false, true)[decode_index(Chip8::Instruction{0xB123})] ==
+          &Chip8::System::jmp_vx_nnn<false>);
+}
+
+TEST_CASE("Instructions without a matching opcode decode to the invalid instruction handler") {
+    using namespace Chip8::InstructionSet;
+
+    CHECK(decode<Chip8::Chip8Quirks>(Chip8::Instruction{0x0000}) == &Chip8::System::invalid);
+    CHECK(decode<Chip8::Chip8Quirks>(Chip8::Instruction{0x5AB1}) != &Chip8::System::invalid);
+    CHECK(decode<Chip8::Chip8Quirks>(Chip8::Instruction{0x800F}) == &Chip8::System::invalid);
+    CHECK(decode<Chip8::Chip8Quirks>(Chip8::Instruction{0xE3FF}) == &Chip8::System::invalid);
+    CHECK(decode<Chip8::Chip8Quirks>(Chip8::Instruction{0xF3FF}) == &Chip8::System::invalid);
+}
+
+TEST_CASE("Emulators with different configurations execute quirk dependent instructions "
+          "according to their own configuration") {
+    Chip8::Emulator chip8{Chip8::Config::chip8()};
+    Chip8::Emulator super_chip{Chip8::Config::super_chip()};
+
+    for (Chip8::Emulator* emulator : {&chip8, &super_chip}) {
+        emulator->system.registers.at(0x1) = 0x10;
+        emulator->system.registers.at(0x2) = 0x04;
+        emulator->decodeInstruction(Chip8::Instruction{0x8126});
+    }
+
+    // Without the shift quirk VY is shifted into VX, with it VX is shifted in place
+    CHECK_EQ(chip8.system.registers.at(0x1), 0x02);
+    CHECK_EQ(super_chip.system.registers.at(0x1), 0x08);
+}
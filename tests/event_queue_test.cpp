@@ -0,0 +1,49 @@
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/event_queue.h"
+
+TEST_CASE("The event queue keeps order, coalesces repeats and drops events when full") {
+    Chip8::EventQueue queue{};
+    queue.push(Chip8::Event::HIRES);
+    queue.push(Chip8::Event::HIRES);
+    queue.push(Chip8::Event::EXIT);
+
+    CHECK_EQ(queue.size(), 2);
+    CHECK_EQ(queue.pop(), std::optional{Chip8::Event::HIRES});
+    CHECK_EQ(queue.pop(), std::optional{Chip8::Event::EXIT});
+    CHECK_FALSE(queue.pop().has_value());
+
+    for (std::uint8_t idx{0}; idx < Chip8::EventQueue::CAPACITY + 1; ++idx) {
+        queue.push(idx % 2 == 0 ? Chip8::Event::LORES : Chip8::Event::HIRES);
+    }
+    CHECK_EQ(queue.size(), Chip8::EventQueue::CAPACITY);
+    CHECK_EQ(queue.dropped(), 1);
+    CHECK_EQ(queue.pop(), std::optional{Chip8::Event::LORES});
+}
+
+TEST_CASE("Instructions and timers raise events for the host") {
+    constexpr std::array<std::uint8_t, 8> PROGRAM{
+        0x00, 0xFF, // 0x200: hires
+        0x60, 0x01, // 0x202: V0 = 1
+        0xF0, 0x18, // 0x204: sound timer = V0
+        0x00, 0xFD, // 0x206: exit
+    };
+
+    Chip8::Emulator emulator{};
+    emulator.loadRom(PROGRAM);
+    emulator.run(PROGRAM.size() / 2);
+    emulator.updateTimers();
+
+    std::array<Chip8::Event, 5> const expected{Chip8::Event::HIRES, Chip8::Event::SOUND_ON,
+                                               Chip8::Event::EXIT, Chip8::Event::SOUND_OFF,
+                                               Chip8::Event::FRAME_READY};
+    for (Chip8::Event const event : expected) {
+        CHECK_EQ(emulator.system.events.pop(), std::optional{event});
+    }
+    CHECK(emulator.system.events.empty());
+}
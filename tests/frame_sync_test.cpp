@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <thread>
+
+#include "doctest/doctest.h"
+
+#include "../src/window/spsc_queue.h"
+#include "../src/window/triple_buffer.h"
+
+TEST_CASE("Triple buffer hands over only the latest published value") {
+    TripleBuffer<int> buffer;
+
+    CHECK_FALSE(buffer.take());
+
+    buffer.back() = 1;
+    buffer.publish();
+    buffer.back() = 2;
+    buffer.publish();
+
+    CHECK(buffer.take());
+    CHECK(buffer.front() == 2);
+    CHECK_FALSE(buffer.take());
+    CHECK(buffer.front() == 2);
+}
+
+TEST_CASE("Triple buffer values arrive intact and in order across threads") {
+    static constexpr std::uint32_t COUNT{100000};
+
+    struct Value {
+        std::uint32_t first;
+        std::uint32_t second;
+    };
+    TripleBuffer<Value> buffer;
+
+    std::jthread producer{[&buffer] {
+        for (std::uint32_t i{1}; i <= COUNT; ++i) {
+            buffer.back() = Value{i, ~i};
+            buffer.publish();
+        }
+    }};
+
+    std::uint32_t last{0};
+    bool torn{false};
+    bool reordered{false};
+    while (last != COUNT) {
+        if (buffer.take()) {
+            Value const value{buffer.front()};
+            torn = torn || value.second != ~value.first;
+            reordered = reordered || value.first <= last;
+            last = value.first;
+        }
+    }
+
+    CHECK_FALSE(torn);
+    CHECK_FALSE(reordered);
+}
+
+TEST_CASE("SPSC queue is FIFO and bounded") {
+    SpscQueue<std::uint8_t, 4> queue;
+
+    CHECK_FALSE(queue.pop().has_value());
+
+    for (std::uint8_t i{0}; i < 4; ++i) {
+        CHECK(queue.push(i));
+    }
+    CHECK_FALSE(queue.push(4));
+
+    for (std::uint8_t i{0}; i < 4; ++i) {
+        CHECK(queue.pop() == i);
+    }
+    CHECK_FALSE(queue.pop().has_value());
+}
@@ -0,0 +1,134 @@
+#include <cstdint>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/framebuffer.h"
+#include "../src/chip8/instruction.h"
+
+TEST_CASE("Drawing a sprite row XORs it onto the framebuffer and reports collisions") {
+    Chip8::Framebuffer framebuffer{64, 32};
+
+    CHECK_FALSE(framebuffer.draw_row(4, 2, 0b10100000, 8));
+    CHECK(framebuffer.pixel(4, 2));
+    CHECK_FALSE(framebuffer.pixel(5, 2));
+    CHECK(framebuffer.pixel(6, 2));
+
+    // Overlapping a lit pixel turns it off and collides
+    CHECK(framebuffer.draw_row(5, 2, 0b11000000, 8));
+    CHECK(framebuffer.pixel(5, 2));
+    CHECK_FALSE(framebuffer.pixel(6, 2));
+}
+
+TEST_CASE("Sprite rows are clipped at the right edge of the current resolution") {
+    Chip8::Framebuffer lores{64, 32};
+
+    CHECK_FALSE(lores.draw_row(60, 0, 0xFF, 8));
+    CHECK(lores.pixel(63, 0));
+    CHECK_EQ(lores.row(0)[1], 0);
+
+    // A second draw only collides within the visible area
+    CHECK(lores.draw_row(60, 0, 0xFF, 8));
+    CHECK_FALSE(lores.pixel(63, 0));
+}
+
+TEST_CASE("16 pixel wide sprite rows are drawn across the word boundary in hires") {
+    Chip8::Framebuffer hires{128, 64};
+
+    CHECK_FALSE(hires.draw_row(56, 10, 0x8001, 16));
+    CHECK(hires.pixel(56, 10));
+    CHECK(hires.pixel(71, 10));
+    CHECK_FALSE(hires.pixel(63, 10));
+    CHECK_FALSE(hires.pixel(64, 10));
+}
+
+TEST_CASE("Scrolling moves pixels within the current resolution and clears uncovered pixels") {
+    Chip8::Framebuffer framebuffer{128, 64};
+    framebuffer.set_pixel(62, 0, true);
+    framebuffer.set_pixel(0, 63, true);
+
+    framebuffer.scroll_right(4);
+    CHECK(framebuffer.pixel(66, 0));
+    CHECK(framebuffer.pixel(4, 63));
+
+    framebuffer.scroll_left(4);
+    framebuffer.scroll_left(4);
+    CHECK(framebuffer.pixel(58, 0));
+    CHECK_FALSE(framebuffer.pixel(0, 63));
+
+    framebuffer.scroll_down(3);
+    CHECK(framebuffer.pixel(58, 3));
+    CHECK_FALSE(framebuffer.pixel(58, 0));
+}
+
+TEST_CASE("Drawing a SUPER-CHIP 16x16 sprite sets the flag register only on collision") {
+    Chip8::Emulator emulator{};
+    emulator.system.display.resize(Chip8::System::HIRES_WIDTH, Chip8::System::HIRES_HEIGHT);
+
+    emulator.system.index_register = 0x300;
+    for (std::uint16_t idx{0}; idx < 32; ++idx) {
+        emulator.system.memory.at(0x300 + idx) = 0xFF;
+    }
+    emulator.system.registers.at(0x0) = 120;
+    emulator.system.registers.at(0x1) = 60;
+
+    emulator.decodeInstruction(Chip8::Instruction{0xD010});
+    CHECK_EQ(emulator.system.registers.at(0xF), 0);
+    CHECK(emulator.system.display.pixel(127, 63));
+    CHECK_FALSE(emulator.system.display.pixel(119, 63));
+
+    emulator.decodeInstruction(Chip8::Instruction{0xD010});
+    CHECK_EQ(emulator.system.registers.at(0xF), 1);
+    CHECK_FALSE(emulator.system.display.pixel(127, 63));
+}
+
+TEST_CASE("Scrolling in lores only affects the lores area, and survives switching resolution") {
+    Chip8::Emulator emulator{};
+    Chip8::System& system{emulator.system};
+
+    system.display.set_pixel(63, 31, true);
+    system.display.set_pixel(10, 0, true);
+
+    // Scroll down 2 (00C2), pushing the bottom row out of the lores area
+    emulator.decodeInstruction(Chip8::Instruction{0x00C2});
+    CHECK(system.display.pixel(10, 2));
+    CHECK_FALSE(system.display.pixel(63, 31));
+
+    // Scroll right (00FB), pushing the pixel out of the lores area rather than into hires
+    system.display.set_pixel(62, 5, true);
+    emulator.decodeInstruction(Chip8::Instruction{0x00FB});
+    CHECK(system.display.pixel(14, 2));
+    CHECK_EQ(system.display.row(5)[1], 0);
+
+    // Switch to hires (00FF): lores pixels stay, and the rest of the screen is blank
+    emulator.decodeInstruction(Chip8::Instruction{0x00FF});
+    CHECK_EQ(system.display.width(), Chip8::System::HIRES_WIDTH);
+    CHECK(system.display.pixel(14, 2));
+    CHECK_FALSE(system.display.pixel(66, 5));
+
+    // Scrolling further than the height clears every row
+    emulator.decodeInstruction(Chip8::Instruction{0x00CF});
+    emulator.decodeInstruction(Chip8::Instruction{0x00CF});
+    emulator.decodeInstruction(Chip8::Instruction{0x00CF});
+    emulator.decodeInstruction(Chip8::Instruction{0x00CF});
+    emulator.decodeInstruction(Chip8::Instruction{0x00CF});
+    Chip8::Framebuffer const blank{Chip8::System::HIRES_WIDTH, Chip8::System::HIRES_HEIGHT};
+    CHECK(system.display == blank);
+}
+
+TEST_CASE("Only rows changed since they were last taken are reported as dirty") {
+    Chip8::Framebuffer framebuffer{64, 32};
+
+    // Everything is dirty initially, as nothing has been rendered
+    CHECK_EQ(framebuffer.take_dirty_rows(), Chip8::Framebuffer::ALL_ROWS);
+    CHECK_EQ(framebuffer.take_dirty_rows(), 0);
+
+    framebuffer.draw_row(0, 3, 0x80, 8);
+    framebuffer.draw_row(0, 5, 0x80, 8);
+    // Sprites entirely clipped off the right edge change nothing
+    framebuffer.draw_row(63, 7, 0x01, 8);
+    CHECK_EQ(framebuffer.take_dirty_rows(), 0b101000);
+
+    framebuffer.scroll_left(4);
+    CHECK_EQ(framebuffer.take_dirty_rows(), 0xFFFFFFFF);
+}
@@ -0,0 +1,76 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/config.h"
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/input_log.h"
+
+namespace {
+// Waits for a key, then draws its font sprite at a random position, forever
+constexpr std::array<std::uint8_t, 12> PROGRAM{
+    0xF0, 0x0A, // 0x200: V0 = next key released
+    0xF0, 0x29, // 0x202: I = font sprite for V0
+    0xC1, 0x3F, // 0x204: V1 = random & 0x3F
+    0xC2, 0x1F, // 0x206: V2 = random & 0x1F
+    0xD1, 0x25, // 0x208: draw at V1, V2
+    0x12, 0x00, // 0x20A: jump to 0x200
+};
+} // namespace
+
+TEST_CASE("Input logs round trip through their serialised form") {
+    Chip8::InputLog log{.config = Chip8::Config::chip8(), .seed = 42, .instructions = 90000,
+                        .events = {}};
+    log.record(15, 0x1, true);
+    log.record(300, 0x1, false);
+    log.record(70000, 0xF, true);
+
+    Chip8::InputLog const read{Chip8::InputLog::deserialise(log.serialise())};
+    CHECK_EQ(read.seed, log.seed);
+    CHECK_EQ(read.instructions, log.instructions);
+    CHECK_EQ(read.config.shift_quirk, log.config.shift_quirk);
+    CHECK_EQ(read.config.tick_rate, log.config.tick_rate);
+    CHECK(read.events == log.events);
+
+    std::vector<std::uint8_t> truncated{log.serialise()};
+    truncated.pop_back();
+    CHECK_THROWS_AS(static_cast<void>(Chip8::InputLog::deserialise(truncated)),
+                    std::runtime_error);
+}
+
+TEST_CASE("Replaying recorded input reproduces the display exactly") {
+    Chip8::Config const config{Chip8::Config::super_chip()};
+    Chip8::InputLog log{.config = config, .seed = 7, .instructions = 0, .events = {}};
+
+    // Record as the window does, with input applied between frames
+    Chip8::Emulator recorder{config};
+    recorder.system.seed(log.seed);
+    recorder.loadRom(PROGRAM);
+    for (std::uint8_t frame{0}; frame < 200; ++frame) {
+        if (frame % 10 == 3 || frame % 10 == 5) {
+            std::uint8_t const key{static_cast<std::uint8_t>(frame % 16)};
+            bool const pressed{frame % 10 == 3};
+            recorder.setKey(key, pressed);
+            log.record(recorder.getInstructionCount(), key, pressed);
+        }
+        recorder.runFrame();
+    }
+    log.instructions = recorder.getInstructionCount();
+
+    Chip8::InputLog const replayed{Chip8::InputLog::deserialise(log.serialise())};
+    Chip8::Emulator player_emulator{replayed.config};
+    player_emulator.system.seed(replayed.seed);
+    player_emulator.loadRom(PROGRAM);
+
+    Chip8::InputPlayer player{replayed};
+    while (player_emulator.getInstructionCount() < replayed.instructions) {
+        player.run(player_emulator, replayed.config.tick_rate);
+        player_emulator.updateTimers();
+    }
+
+    CHECK_EQ(player_emulator.system.display.hash(), recorder.system.display.hash());
+    CHECK_EQ(player_emulator.system.registers, recorder.system.registers);
+}
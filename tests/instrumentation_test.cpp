@@ -0,0 +1,42 @@
+#ifdef CHIP8_INSTRUMENTATION
+#include <array>
+#include <cstdint>
+#include <sstream>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/instruction.h"
+#include "../src/chip8/instruction_set.h"
+#include "../src/chip8/instrumentation.h"
+
+TEST_CASE("Instrumentation counts executions per handler and per address") {
+    // 0x200: V0 += 1, 0x202: V1 += V0, 0x204: jump to 0x200
+    constexpr std::array<std::uint8_t, 6> PROGRAM{0x70, 0x01, 0x81, 0x04, 0x12, 0x00};
+
+    Chip8::Emulator emulator{};
+    emulator.loadRom(PROGRAM);
+    emulator.run(3000);
+
+    Chip8::InstrumentationStats const& stats{emulator.getStats()};
+    std::uint8_t const add_index{
+        Chip8::InstructionSet::decode_index(Chip8::Instruction{std::uint16_t{0x7001}})};
+    std::uint8_t const jump_index{
+        Chip8::InstructionSet::decode_index(Chip8::Instruction{std::uint16_t{0x1200}})};
+
+    CHECK_EQ(stats.total_executions(), 3000);
+    CHECK_EQ(stats.executions.at(add_index), 1000);
+    CHECK_EQ(stats.executions.at(jump_index), 1000);
+    CHECK_EQ(Chip8::InstrumentationStats::handler_name(add_index), "7XNN add_vx_nn");
+    CHECK_EQ(stats.address_executions.at(0x202), 1000);
+    CHECK_EQ(stats.hotspots(3).size(), 3);
+    CHECK_GT(stats.samples.at(add_index), 0);
+
+    std::ostringstream report{};
+    stats.report(report);
+    CHECK_NE(report.str().find("add_vx_nn"), std::string::npos);
+
+    emulator.resetStats();
+    CHECK_EQ(emulator.getStats().total_executions(), 0);
+}
+#endif
@@ -0,0 +1,98 @@
+#include <array>
+#include <cstdint>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/jit.h"
+
+namespace {
+// Loop mixing inlined and called instructions, with a memory write and a skip to exit
+constexpr std::array<std::uint16_t, 14> PROGRAM{
+    0x6005, // 0x200: V0 = 0x05
+    0x6103, // 0x202: V1 = 0x03
+    0x8014, // 0x204: V0 += V1
+    0x8211, // 0x206: V2 |= V1
+    0x7301, // 0x208: V3 += 0x01
+    0xA300, // 0x20A: I = 0x300
+    0xF31E, // 0x20C: I += V3
+    0xF255, // 0x20E: store V0 to V2 at I
+    0x8432, // 0x210: V4 &= V3
+    0x8533, // 0x212: V5 ^= V3
+    0x8630, // 0x214: V6 = V3
+    0x3380, // 0x216: skip if V3 == 0x80
+    0x1204, // 0x218: jump to 0x204
+    0x121A, // 0x21A: jump to self
+};
+
+void load_program(Chip8::Emulator& emulator) {
+    for (std::size_t idx{0}; idx < PROGRAM.size(); ++idx) {
+        emulator.system.memory.at(0x200 + (2 * idx)) = PROGRAM.at(idx) >> 8;
+        emulator.system.memory.at(0x200 + (2 * idx) + 1) = PROGRAM.at(idx) & 0xFF;
+    }
+    emulator.system.program_counter = 0x200;
+    emulator.invalidateCache();
+}
+} // namespace
+
+TEST_CASE("Running a program with the JIT results in the same state as the interpreter") {
+    if (!Chip8::Jit::supported()) {
+        return;
+    }
+
+    Chip8::Emulator interpreted{};
+    Chip8::Emulator compiled{};
+    load_program(interpreted);
+    load_program(compiled);
+    compiled.setBackend(Chip8::Backend::JIT);
+
+    // An odd number of cycles, so that the final block cannot run natively
+    interpreted.run(1001);
+    compiled.run(1001);
+
+    CHECK_EQ(compiled.system.program_counter, interpreted.system.program_counter);
+    CHECK_EQ(compiled.system.index_register, interpreted.system.index_register);
+    CHECK(compiled.system.registers == interpreted.system.registers);
+    CHECK(compiled.system.memory == interpreted.system.memory);
+}
+
+TEST_CASE("Running a program with the verifying JIT backend finds no mismatches") {
+    if (!Chip8::Jit::supported()) {
+        return;
+    }
+
+    Chip8::Emulator emulator{};
+    load_program(emulator);
+    emulator.setBackend(Chip8::Backend::JIT_VERIFY);
+
+    CHECK_NOTHROW(emulator.run(5000));
+    CHECK_EQ(emulator.system.program_counter, 0x21A);
+}
+
+TEST_CASE("Writing over compiled code with FX55 results in the new instructions being executed") {
+    if (!Chip8::Jit::supported()) {
+        return;
+    }
+
+    constexpr std::array<std::uint8_t, 18> PROGRAM{
+        0x72, 0x01, // 0x200: V2 += 1
+        0x60, 0x05, // 0x202: V0 = 0x05, overwritten with V0 = 0x09 on the third pass
+        0x32, 0x03, // 0x204: skip if V2 == 3
+        0x12, 0x00, // 0x206: jump to 0x200
+        0xA2, 0x02, // 0x208: I = 0x202
+        0x60, 0x60, // 0x20A: V0 = 0x60
+        0x61, 0x09, // 0x20C: V1 = 0x09
+        0xF1, 0x55, // 0x20E: store V0 to V1 at I
+        0x12, 0x00, // 0x210: jump to 0x200
+    };
+
+    for (Chip8::Backend const backend : {Chip8::Backend::JIT, Chip8::Backend::JIT_VERIFY}) {
+        Chip8::Emulator emulator{};
+        emulator.loadRom(PROGRAM);
+        emulator.setBackend(backend);
+
+        CHECK_NOTHROW(emulator.run(101));
+        CHECK_EQ(emulator.system.memory.at(0x203), 0x09);
+        CHECK_EQ(emulator.system.registers.at(0x0), 0x09);
+    }
+}
@@ -0,0 +1,46 @@
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/profiler.h"
+
+TEST_CASE("The profiler attributes samples to call stacks and addresses") {
+    constexpr std::array<std::uint8_t, 14> PROGRAM{
+        0x22, 0x04, // 0x200: call 0x204
+        0x12, 0x00, // 0x202: jump to 0x200
+        0x22, 0x0A, // 0x204: call 0x20A
+        0x00, 0xEE, // 0x206: return
+        0x00, 0x00, // 0x208: unused
+        0x70, 0x01, // 0x20A: V0 += 1
+        0x00, 0xEE, // 0x20C: return
+    };
+
+    Chip8::Emulator emulator{};
+    emulator.loadRom(PROGRAM);
+
+    Chip8::Profiler profiler{7};
+    profiler.run(emulator, 70000);
+    CHECK_GT(profiler.sample_count(), 9000);
+    CHECK_LT(profiler.sample_count(), 11000);
+
+    // Every address of the loop is sampled, and nothing else
+    auto const& heat{profiler.heat_map()};
+    CHECK_GT(heat.at(0x200), 0);
+    CHECK_GT(heat.at(0x20C), 0);
+    CHECK_EQ(heat.at(0x208), 0);
+
+    std::ostringstream folded{};
+    profiler.write_folded(folded);
+    std::string const stacks{folded.str()};
+    CHECK_NE(stacks.find("main "), std::string::npos);
+    CHECK_NE(stacks.find("main;sub_204 "), std::string::npos);
+    CHECK_NE(stacks.find("main;sub_204;sub_20A "), std::string::npos);
+
+    std::ostringstream heat_map{};
+    profiler.write_heat_map(heat_map);
+    CHECK_NE(heat_map.str().find("0x200 |"), std::string::npos);
+}
@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/random.h"
+
+TEST_CASE("PCG32 is small, cheap to copy and reproducible from a seed") {
+    static_assert(sizeof(Chip8::Pcg32) == sizeof(std::uint64_t));
+    static_assert(std::is_trivially_copyable_v<Chip8::Pcg32>);
+
+    Chip8::Pcg32 first{1234};
+    Chip8::Pcg32 second{1234};
+    Chip8::Pcg32 other{1235};
+
+    bool same{true};
+    bool differs{false};
+    for (int i{0}; i < 100; ++i) {
+        std::uint32_t const value{first()};
+        same = same && value == second();
+        differs = differs || value != other();
+    }
+    CHECK(same);
+    CHECK(differs);
+}
+
+TEST_CASE("RND produces every byte value") {
+    // 0x200: V0 = random & 0xFF, 0x202: jump to 0x200
+    constexpr std::array<std::uint8_t, 4> PROGRAM{0xC0, 0xFF, 0x12, 0x00};
+
+    Chip8::Emulator emulator{};
+    emulator.system.seed(5);
+    emulator.loadRom(PROGRAM);
+
+    std::array<bool, 256> seen{};
+    for (int i{0}; i < 4096; ++i) {
+        emulator.run(2);
+        seen.at(emulator.system.registers.at(0x0)) = true;
+    }
+    CHECK(std::ranges::all_of(seen, [](bool const value) { return value; }));
+}
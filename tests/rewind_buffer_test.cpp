@@ -0,0 +1,73 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/rewind_buffer.h"
+#include "../src/chip8/save_state.h"
+
+namespace {
+// Draws random font sprites at random positions, forever
+constexpr std::array<std::uint8_t, 12> PROGRAM{
+    0xC0, 0x0F, // 0x200: V0 = random & 0x0F
+    0xF0, 0x29, // 0x202: I = font sprite for V0
+    0xC1, 0x3F, // 0x204: V1 = random & 0x3F
+    0xC2, 0x1F, // 0x206: V2 = random & 0x1F
+    0xD1, 0x25, // 0x208: draw at V1, V2
+    0x12, 0x00, // 0x20A: jump to 0x200
+};
+
+bool same_bytes(Chip8::SaveState const& a, Chip8::SaveState const& b) {
+    return std::memcmp(&a, &b, sizeof(Chip8::SaveState)) == 0;
+}
+} // namespace
+
+TEST_CASE("Rewinding returns every recorded state, newest first") {
+    Chip8::Emulator emulator{};
+    emulator.system.seed(99);
+    emulator.loadRom(PROGRAM);
+
+    Chip8::RewindBuffer rewind{1 << 20, 8};
+    std::vector<Chip8::SaveState> expected{};
+    for (int frame{0}; frame < 30; ++frame) {
+        emulator.runFrame();
+        expected.push_back(emulator.saveState());
+        rewind.push(expected.back());
+    }
+    CHECK_EQ(rewind.size(), expected.size());
+    // Only the keyframes are stored in full
+    CHECK_LT(rewind.memory_usage(), 5 * sizeof(Chip8::SaveState));
+
+    Chip8::SaveState state{};
+    bool all_match{true};
+    while (!expected.empty()) {
+        REQUIRE(rewind.pop(state));
+        all_match = all_match && same_bytes(state, expected.back());
+        expected.pop_back();
+    }
+    CHECK(all_match);
+    CHECK_FALSE(rewind.pop(state));
+    CHECK_EQ(rewind.memory_usage(), 0);
+}
+
+TEST_CASE("The oldest history is dropped to stay within budget") {
+    Chip8::Emulator emulator{};
+    emulator.loadRom(PROGRAM);
+
+    std::size_t const budget{3 * sizeof(Chip8::SaveState)};
+    Chip8::RewindBuffer rewind{budget, 4};
+    for (int frame{0}; frame < 100; ++frame) {
+        emulator.runFrame();
+        rewind.push(emulator.saveState());
+        CHECK_LE(rewind.memory_usage(), budget);
+    }
+
+    // The newest state is still exact
+    Chip8::SaveState state{};
+    REQUIRE(rewind.pop(state));
+    CHECK(same_bytes(state, emulator.saveState()));
+    CHECK_LT(rewind.size(), 100);
+}
@@ -0,0 +1,56 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/rom_database.h"
+
+namespace {
+std::filesystem::path write_database(char const* const contents) {
+    // Named uniquely, so that test runs in parallel do not share the file
+    std::filesystem::path const path{
+        std::filesystem::temp_directory_path() /
+        ("chip8_rom_database_test_" + std::to_string(std::random_device{}()) + ".txt")};
+    std::ofstream{path} << contents;
+    return path;
+}
+} // namespace
+
+TEST_CASE("ROM profiles are found by the hash of the ROM") {
+    std::filesystem::path const path{
+        write_database("# hash quirks ipf foreground background name\n"
+                       "\n"
+                       "00000000000000AB chip8 11 33FF66 101010 Pong 2\n"
+                       "cd xochip 1000 FFFFFF 000000\n")};
+    Chip8::RomDatabase const database{Chip8::RomDatabase::read(path)};
+    std::filesystem::remove(path);
+
+    REQUIRE_EQ(database.size(), 2);
+
+    Chip8::RomProfile const* const pong{database.find(0xAB)};
+    REQUIRE(pong != nullptr);
+    CHECK_EQ(pong->name, "Pong 2");
+    CHECK_FALSE(pong->config.shift_quirk);
+    CHECK_EQ(pong->config.max_width, Chip8::System::LORES_WIDTH);
+    CHECK_EQ(pong->config.tick_rate, 11);
+    CHECK_EQ(pong->foreground, 0xFF33FF66);
+    CHECK_EQ(pong->background, 0xFF101010);
+
+    CHECK_EQ(database.find(0xCD)->config.tick_rate, 1000);
+    CHECK(database.find(0xCD)->name.empty());
+    CHECK_EQ(database.find(0xEF), nullptr);
+}
+
+TEST_CASE("Malformed ROM databases are rejected") {
+    for (char const* const contents :
+         {"AB chip8 11 FFFFFF\n", "AB superchip 11 FFFFFF 000000\n", "AB chip8 0 FFFFFF 000000\n",
+          "AB chip8 11 FFF 000000\n", "AB chip8 11 0x1234 000000\n",
+          "XY chip8 11 FFFFFF 000000\n"}) {
+        std::filesystem::path const path{write_database(contents)};
+        CHECK_THROWS_AS(Chip8::RomDatabase::read(path), std::runtime_error);
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/rom_library.h"
+#include "../src/chip8/system.h"
+
+namespace {
+void write_rom(std::filesystem::path const& path, std::vector<std::uint8_t> const& rom) {
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<char const*>(rom.data()), static_cast<std::streamsize>(rom.size()));
+}
+} // namespace
+
+TEST_CASE("ROMs too large to fit in memory are rejected") {
+    std::vector<std::uint8_t> const rom(Chip8::System::MAX_ROM_SIZE + 1);
+
+    Chip8::Emulator emulator{};
+    CHECK_THROWS_AS(emulator.loadRom(rom), std::runtime_error);
+    CHECK_NOTHROW(emulator.loadRom(std::span{rom}.first(Chip8::System::MAX_ROM_SIZE)));
+}
+
+TEST_CASE("The ROM library indexes ROMs by content, surviving a reopen") {
+    std::filesystem::path const directory{std::filesystem::temp_directory_path() /
+                                          "chip8_rom_library_test"};
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory / "nested");
+
+    write_rom(directory / "a.ch8", {0x12, 0x00});
+    write_rom(directory / "nested" / "b.ch8", {0x60, 0x01, 0x12, 0x02});
+    write_rom(directory / "notes.txt", {0x00});
+    write_rom(directory / "huge.ch8", std::vector<std::uint8_t>(Chip8::System::MAX_ROM_SIZE + 1));
+
+    std::filesystem::path const index{directory / "index.tsv"};
+    std::uint64_t const expected{Chip8::rom_hash(std::vector<std::uint8_t>{0x12, 0x00})};
+    {
+        Chip8::RomLibrary library{index};
+        std::vector<Chip8::RomInfo> const roms{library.scan_directory(directory)};
+
+        REQUIRE_EQ(roms.size(), 2);
+        CHECK_EQ(roms[0].hash, expected);
+        CHECK_EQ(roms[0].size, 2);
+        CHECK_EQ(roms[1].size, 4);
+        library.save();
+    }
+
+    Chip8::RomLibrary reopened{index};
+    CHECK_EQ(reopened.size(), 2);
+    CHECK_EQ(reopened.find(expected)->size, 2);
+    CHECK_FALSE(reopened.find(0).has_value());
+
+    // Changing a ROM is picked up on its next scan
+    write_rom(directory / "a.ch8", {0x12, 0x00, 0x00, 0xE0});
+    CHECK_NE(reopened.scan(directory / "a.ch8").hash, expected);
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/framebuffer.h"
+#include "../src/chip8/save_state.h"
+#include "../src/chip8/system.h"
+
+namespace {
+// Draws the font sprite of a random digit at a random position from a subroutine, forever
+constexpr std::array<std::uint8_t, 16> PROGRAM{
+    0x22, 0x04, // 0x200: call 0x204
+    0x12, 0x00, // 0x202: jump to 0x200
+    0xC0, 0x0F, // 0x204: V0 = random & 0x0F
+    0xF0, 0x29, // 0x206: I = font sprite for V0
+    0xC1, 0x3F, // 0x208: V1 = random & 0x3F
+    0xC2, 0x1F, // 0x20A: V2 = random & 0x1F
+    0xD1, 0x25, // 0x20C: draw at V1, V2
+    0x00, 0xEE, // 0x20E: return
+};
+
+Chip8::Emulator make_emulator() {
+    Chip8::Emulator emulator{};
+    emulator.system.seed(1234);
+    emulator.loadRom(PROGRAM);
+    return emulator;
+}
+} // namespace
+
+TEST_CASE("Loading a save state resumes execution identically") {
+    Chip8::Emulator emulator{make_emulator()};
+    emulator.run(1001);
+    REQUIRE_EQ(emulator.system.stack_depth, 1);
+
+    Chip8::SaveState const state{emulator.saveState()};
+    emulator.run(5000);
+    std::uint64_t const expected_hash{emulator.system.display.hash()};
+    std::uint16_t const expected_pc{emulator.system.program_counter};
+
+    // Restore into a different emulator, with its own random state
+    Chip8::Emulator restored{};
+    restored.loadState(state.bytes());
+    restored.run(5000);
+
+    CHECK_EQ(restored.system.display.hash(), expected_hash);
+    CHECK_EQ(restored.system.program_counter, expected_pc);
+    CHECK_EQ(restored.system.registers, emulator.system.registers);
+}
+
+TEST_CASE("Save states round trip through a file") {
+    Chip8::Emulator emulator{make_emulator()};
+    emulator.run(777);
+
+    std::filesystem::path const path{std::filesystem::temp_directory_path() /
+                                     "chip8_save_state_test.c8st"};
+    emulator.saveState(path.string());
+
+    Chip8::Emulator restored{};
+    restored.loadState(path.string());
+    std::filesystem::remove(path);
+
+    CHECK(restored.system.display == emulator.system.display);
+    CHECK_EQ(restored.system.memory, emulator.system.memory);
+    CHECK_EQ(restored.system.index_register, emulator.system.index_register);
+}
+
+TEST_CASE("Invalid save states are rejected") {
+    Chip8::SaveState const state{make_emulator().saveState()};
+    std::vector<std::byte> bytes{state.bytes().begin(), state.bytes().end()};
+
+    Chip8::Emulator emulator{};
+    CHECK_THROWS_AS(emulator.loadState(std::span{bytes}.first(bytes.size() - 1)),
+                    std::runtime_error);
+
+    bytes.front() = std::byte{'X'};
+    CHECK_THROWS_AS(emulator.loadState(std::span<std::byte const>{bytes}), std::runtime_error);
+}
+
+TEST_CASE("Save states with out of range fields are rejected as corrupt") {
+    Chip8::SaveState const state{make_emulator().saveState()};
+    std::vector<std::byte> const original{state.bytes().begin(), state.bytes().end()};
+    Chip8::Emulator emulator{};
+
+    SUBCASE("a display of no size") {
+        std::vector<std::byte> bytes{original};
+        std::fill_n(bytes.begin() + offsetof(Chip8::SaveState, display), sizeof(Chip8::Framebuffer),
+                    std::byte{0});
+        CHECK_THROWS_AS(emulator.loadState(std::span<std::byte const>{bytes}), std::runtime_error);
+    }
+
+    SUBCASE("a program counter outside memory") {
+        std::vector<std::byte> bytes{original};
+        std::uint16_t const program_counter{Chip8::System::MEMORY_SIZE};
+        std::memcpy(bytes.data() + offsetof(Chip8::SaveState, program_counter), &program_counter,
+                    sizeof(program_counter));
+        CHECK_THROWS_AS(emulator.loadState(std::span<std::byte const>{bytes}), std::runtime_error);
+    }
+
+    SUBCASE("a bool which is neither true nor false") {
+        std::vector<std::byte> bytes{original};
+        bytes[offsetof(Chip8::SaveState, waiting)] = std::byte{2};
+        CHECK_THROWS_AS(emulator.loadState(std::span<std::byte const>{bytes}), std::runtime_error);
+    }
+}
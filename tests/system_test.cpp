@@ -0,0 +1,50 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "doctest/doctest.h"
+
+#include "../src/chip8/emulator.h"
+#include "../src/chip8/system.h"
+
+TEST_CASE("The state used by most instructions fits in the first cache line of a system") {
+    Chip8::System const system{};
+    auto const offset{[&system](void const* const member) {
+        return static_cast<std::byte const*>(member) - reinterpret_cast<std::byte const*>(&system);
+    }};
+
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(&system) % 64, 0);
+    CHECK_LE(offset(&system.program_counter + 1), 64);
+    CHECK_LE(offset(&system.index_register + 1), 64);
+    CHECK_LE(offset(&system.registers + 1), 64);
+    CHECK_LE(offset(&system.sound_timer + 1), 64);
+    CHECK_LE(offset(&system.stack + 1), 64);
+}
+
+TEST_CASE("Calling with a full stack or returning with an empty one faults") {
+    SUBCASE("Overflow") {
+        // Calls itself forever
+        constexpr std::array<std::uint8_t, 2> PROGRAM{0x22, 0x00};
+
+        Chip8::Emulator emulator{};
+        emulator.loadRom(PROGRAM);
+        emulator.run(Chip8::System::STACK_DEPTH);
+        CHECK_EQ(emulator.system.stack_depth, Chip8::System::STACK_DEPTH);
+
+        CHECK_THROWS_AS(emulator.run(1), std::runtime_error);
+        CHECK_EQ(emulator.system.stack_depth, Chip8::System::STACK_DEPTH);
+        CHECK_EQ(emulator.system.fault, Chip8::Fault::NONE);
+    }
+
+    SUBCASE("Underflow") {
+        constexpr std::array<std::uint8_t, 2> PROGRAM{0x00, 0xEE};
+
+        Chip8::Emulator emulator{};
+        emulator.loadRom(PROGRAM);
+
+        CHECK_THROWS_AS(emulator.cycle(), std::runtime_error);
+        CHECK_EQ(emulator.system.stack_depth, 0);
+        CHECK_EQ(emulator.system.program_counter, 0x202);
+    }
+}